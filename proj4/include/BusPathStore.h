@@ -0,0 +1,30 @@
+#ifndef BUSPATHSTORE_H
+#define BUSPATHSTORE_H
+
+#include "StreetMap.h"
+#include "DSVReader.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Precomputed road geometry for bus route segments (data/buspaths.csv), each
+// row holds src_id, dest_id, routes (underscore separated) and the node path.
+class CBusPathStore{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        using TNodeID = CStreetMap::TNodeID;
+
+        CBusPathStore(std::shared_ptr<CDSVReader> src);
+        ~CBusPathStore();
+
+        std::size_t SegmentCount() const noexcept;
+        std::size_t PathNodeCount() const noexcept;
+        bool HasPath(TNodeID src, TNodeID dest) const noexcept;
+        bool GetPath(TNodeID src, TNodeID dest, std::vector<TNodeID> &path) const noexcept;
+        std::vector<std::string> GetRoutes(TNodeID src, TNodeID dest) const noexcept;
+};
+
+#endif
@@ -30,6 +30,26 @@ class CBusSystem{
         virtual std::shared_ptr<SStop> StopByID(TStopID id) const noexcept = 0;
         virtual std::shared_ptr<SRoute> RouteByIndex(std::size_t index) const noexcept = 0;
         virtual std::shared_ptr<SRoute> RouteByName(const std::string &name) const noexcept = 0;
+
+        // Non-owning lookups valid for as long as the bus system, see the
+        // pointer accessors of CStreetMap
+        virtual const SStop *StopPtrByIndex(std::size_t index) const noexcept{
+            return StopByIndex(index).get();
+        }
+        virtual const SStop *StopPtrByID(TStopID id) const noexcept{
+            return StopByID(id).get();
+        }
+        virtual const SRoute *RoutePtrByIndex(std::size_t index) const noexcept{
+            return RouteByIndex(index).get();
+        }
+        virtual const SRoute *RoutePtrByName(const std::string &name) const noexcept{
+            return RouteByName(name).get();
+        }
+
+        // Load time and memory profile, false if the system does not keep one
+        virtual bool ConstructionReport(SConstructionReport &report) const noexcept{
+            return false;
+        }
 };
 
 #endif
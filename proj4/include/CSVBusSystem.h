@@ -18,6 +18,11 @@ public:
     std::shared_ptr<CBusSystem::SStop> StopByID(TStopID id) const noexcept override;
     std::shared_ptr<CBusSystem::SRoute> RouteByIndex(std::size_t index) const noexcept override;
     std::shared_ptr<CBusSystem::SRoute> RouteByName(const std::string &name) const noexcept override;
+    const CBusSystem::SStop *StopPtrByIndex(std::size_t index) const noexcept override;
+    const CBusSystem::SStop *StopPtrByID(TStopID id) const noexcept override;
+    const CBusSystem::SRoute *RoutePtrByIndex(std::size_t index) const noexcept override;
+    const CBusSystem::SRoute *RoutePtrByName(const std::string &name) const noexcept override;
+    bool ConstructionReport(SConstructionReport &report) const noexcept override;
 
 private:
     struct SStop;
@@ -0,0 +1,42 @@
+#ifndef COMPACTPATH_H
+#define COMPACTPATH_H
+
+#include "StreetMap.h"
+#include <cstdint>
+#include <vector>
+
+// Node path stored as one zigzag varint per node holding the delta from the
+// previous node ID. Consecutive nodes of a street path usually have nearby
+// IDs, so most nodes take one or two bytes instead of eight. Meant for
+// callers that keep many paths around, the path is decoded back into a
+// reusable vector when it is needed.
+class CCompactPath{
+    private:
+        std::vector<std::uint8_t> DBytes;
+        std::size_t DNodeCount = 0;
+
+    public:
+        using TNodeID = CStreetMap::TNodeID;
+
+        CCompactPath() = default;
+        CCompactPath(const std::vector<TNodeID> &path);
+
+        void Encode(const std::vector<TNodeID> &path);
+        bool Decode(std::vector<TNodeID> &path) const;
+        void Clear() noexcept;
+
+        bool Empty() const noexcept;
+        std::size_t NodeCount() const noexcept;
+        std::size_t ByteCount() const noexcept;
+        const std::vector<std::uint8_t> &Bytes() const noexcept;
+
+        bool operator==(const CCompactPath &other) const noexcept;
+
+        // Building blocks shared with the other path codecs
+        static void WriteVarint(std::uint64_t value, std::vector<std::uint8_t> &encoded);
+        static bool ReadVarint(const std::vector<std::uint8_t> &encoded, std::size_t &index, std::uint64_t &value);
+        static void WriteDelta(TNodeID previous, TNodeID current, std::vector<std::uint8_t> &encoded);
+        static bool ReadDelta(const std::vector<std::uint8_t> &encoded, std::size_t &index, TNodeID &current);
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef CONSTRUCTIONREPORT_H
+#define CONSTRUCTIONREPORT_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Build profile of a loaded data structure: the wall time of each
+// construction phase and an estimate of the heap bytes held by each kind of
+// item (nodes, edges, tags...) so the cost per item can be read off.
+struct SConstructionReport{
+    struct SPhase{
+        std::string DName;
+        std::chrono::nanoseconds DTime;
+    };
+
+    struct SComponent{
+        std::string DName;
+        std::size_t DCount;
+        std::size_t DBytes;
+    };
+
+    // Records consecutive phases, each Lap closes the phase running since
+    // the previous lap or since construction
+    class CPhaseTimer{
+        private:
+            SConstructionReport &DReport;
+            std::chrono::steady_clock::time_point DStart;
+
+        public:
+            CPhaseTimer(SConstructionReport &report) : DReport(report), DStart(std::chrono::steady_clock::now()){}
+
+            void Lap(const std::string &name){
+                auto Now = std::chrono::steady_clock::now();
+                DReport.AddPhase(name,std::chrono::duration_cast<std::chrono::nanoseconds>(Now - DStart));
+                DStart = Now;
+            }
+    };
+
+    std::string DName;
+    std::vector<SPhase> DPhases;
+    std::vector<SComponent> DComponents;
+
+    void AddPhase(const std::string &name, std::chrono::nanoseconds time);
+    void AddComponent(const std::string &name, std::size_t count, std::size_t bytes);
+    // Adds the components of another report with its name as a prefix
+    void AddComponents(const SConstructionReport &other);
+    std::chrono::nanoseconds TotalTime() const noexcept;
+    std::size_t TotalBytes() const noexcept;
+    // Table with one line per phase and per component
+    std::string ToString() const;
+
+    // Heap estimates for standard containers under libstdc++. Strings only
+    // allocate once they outgrow their inline buffer, hash maps hold a
+    // bucket array and one node per element with its cached hash.
+    template <typename TAllocator>
+    static std::size_t StringBytes(const std::basic_string<char, std::char_traits<char>, TAllocator> &str) noexcept{
+        // libstdc++ keeps up to 15 characters inline
+        return str.capacity() > 15 ? str.capacity() + 1 : 0;
+    }
+
+    template <typename T, typename TAllocator>
+    static std::size_t VectorBytes(const std::vector<T, TAllocator> &vec) noexcept{
+        return vec.capacity() * sizeof(T);
+    }
+
+    template <typename TKey, typename TValue, typename THash, typename TEqual, typename TAllocator>
+    static std::size_t HashMapBytes(const std::unordered_map<TKey, TValue, THash, TEqual, TAllocator> &map) noexcept{
+        // A map that never grew uses its inline single bucket
+        std::size_t Buckets = map.bucket_count() > 1 ? map.bucket_count() * sizeof(void *) : 0;
+        return Buckets + map.size() * (sizeof(void *) + sizeof(std::pair<const TKey, TValue>) + sizeof(std::size_t));
+    }
+
+    // make_shared puts the object and its control block in one allocation
+    template <typename T>
+    static constexpr std::size_t SharedObjectBytes() noexcept{
+        return sizeof(T) + 2 * sizeof(void *) + 2 * sizeof(int);
+    }
+};
+
+#endif
@@ -2,22 +2,159 @@
 #define DIJKSTRAPATHROUTER_H
 
 #include "PathRouter.h"
+#include "ConstructionReport.h"
 #include <memory>
+#include <unordered_map>
 
 class CDijkstraPathRouter : public CPathRouter{
     private:
         struct SImplementation;
         std::unique_ptr<SImplementation> DImplementation;
+
+    protected:
+        // Adds a vertex without a tag, for routers that keep their own tags
+        TVertexID AddUntaggedVertex() noexcept;
+
     public:
-        CDijkstraPathRouter();
+        // Priority queue used by FindShortestPath. RadixHeap needs integer
+        // keys and is only used with fixed point weights, otherwise the
+        // search falls back to BinaryHeap.
+        enum class EQueueType {BinaryHeap, QuaternaryHeap, RadixHeap};
+
+        // Work done by point to point searches, times are split between
+        // setting up the search, the search loop and building the path.
+        struct SSearchStatistics{
+            std::size_t DSearches = 0;
+            std::size_t DSettledVertices = 0;
+            std::size_t DRelaxedEdges = 0;
+            std::size_t DHeapPushes = 0;
+            std::size_t DHeapPops = 0;
+            std::size_t DMaxHeapSize = 0;
+            std::chrono::nanoseconds DSetupTime{0};
+            std::chrono::nanoseconds DSearchTime{0};
+            std::chrono::nanoseconds DPathTime{0};
+
+            SSearchStatistics &operator+=(const SSearchStatistics &other){
+                DSearches += other.DSearches;
+                DSettledVertices += other.DSettledVertices;
+                DRelaxedEdges += other.DRelaxedEdges;
+                DHeapPushes += other.DHeapPushes;
+                DHeapPops += other.DHeapPops;
+                DMaxHeapSize = std::max(DMaxHeapSize,other.DMaxHeapSize);
+                DSetupTime += other.DSetupTime;
+                DSearchTime += other.DSearchTime;
+                DPathTime += other.DPathTime;
+                return *this;
+            }
+        };
+
+        CDijkstraPathRouter(EQueueType queue = EQueueType::BinaryHeap);
         ~CDijkstraPathRouter();
 
         std::size_t VertexCount() const noexcept;
         TVertexID AddVertex(std::any tag) noexcept;
         std::any GetVertexTag(TVertexID id) const noexcept;
         bool AddEdge(TVertexID src, TVertexID dest, double weight, bool bidir = false) noexcept;
+        // Capacity for count vertices in total
+        virtual void ReserveVertices(std::size_t count);
         bool Precompute(std::chrono::steady_clock::time_point deadline) noexcept;
         double FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path) noexcept;
+        double FindShortestPathBetweenSets(const std::vector<std::pair<TVertexID, double>> &sources,
+                                           const std::vector<std::pair<TVertexID, double>> &targets,
+                                           std::vector<TVertexID> &path) noexcept override;
+        bool FindShortestPathTree(TVertexID src, std::vector<double> &dist, std::vector<TVertexID> &prev, double maxcost = NoPathExists) noexcept override;
+        bool FindShortestPathTrees(const std::vector<TVertexID> &sources, std::vector<std::vector<double>> &dist) noexcept override;
+        std::size_t ModificationCount() const noexcept override;
+
+        EQueueType QueueType() const noexcept;
+        void SetQueueType(EQueueType queue) noexcept;
+        // Fixed point units per unit of weight, FindShortestPath searches on
+        // weights rounded to these units (at least one per edge) while still
+        // returning the exact cost of the path. Zero searches on doubles.
+        double FixedPointScale() const noexcept;
+        bool SetFixedPointScale(double scale) noexcept;
+        // True when Precompute built a hierarchy that is still current
+        bool HasHierarchy() const noexcept;
+        // Statistics are off by default and cost nothing until enabled, then
+        // FindShortestPath and FindShortestPathBetweenSets record each search
+        // and add it to a running total until reset. Searches may run
+        // concurrently, the last search is whichever finished last.
+        void SetSearchStatisticsEnabled(bool enable) noexcept;
+        bool SearchStatisticsEnabled() const noexcept;
+        SSearchStatistics LastSearchStatistics() const noexcept;
+        SSearchStatistics SearchStatistics() const noexcept;
+        void ResetSearchStatistics() noexcept;
+        // Time of the last Precompute and memory held by vertices, edges and
+        // the hierarchy
+        virtual bool ConstructionReport(SConstructionReport &report) const noexcept;
+};
+
+// Router whose vertex tags all have one type, kept in a contiguous vector
+// rather than as a std::any per vertex. With indextags set it also maps tags
+// back to vertices, the first vertex added with a tag keeps it, which needs
+// a hashable TTag. The std::any interface still works as long as the tags
+// passed in hold a TTag, others are refused with InvalidVertexID.
+template <typename TTag>
+class CDijkstraPathRouterT : public CDijkstraPathRouter{
+    private:
+        std::vector<TTag> DTags;
+        bool DIndexTags;
+        std::unordered_map<TTag, TVertexID> DTagIndex;
+
+    public:
+        CDijkstraPathRouterT(bool indextags = false, EQueueType queue = EQueueType::BinaryHeap)
+            : CDijkstraPathRouter(queue), DIndexTags(indextags){}
+
+        TVertexID AddVertex(const TTag &tag) noexcept{
+            DTags.push_back(tag);
+            TVertexID Vertex = AddUntaggedVertex();
+            if(DIndexTags){
+                DTagIndex.emplace(tag,Vertex);
+            }
+            return Vertex;
+        }
+
+        TVertexID AddVertex(std::any tag) noexcept override{
+            auto Tag = std::any_cast<TTag>(&tag);
+            return Tag ? AddVertex(*Tag) : InvalidVertexID;
+        }
+
+        // Tag of a vertex, id must be less than VertexCount()
+        const TTag &VertexTag(TVertexID id) const noexcept{
+            return DTags[id];
+        }
+
+        std::any GetVertexTag(TVertexID id) const noexcept override{
+            return id < DTags.size() ? std::any(DTags[id]) : std::any();
+        }
+
+        // Vertex with a tag, InvalidVertexID if there is none or tags are not
+        // indexed
+        TVertexID VertexByTag(const TTag &tag) const noexcept{
+            auto Search = DTagIndex.find(tag);
+            return Search == DTagIndex.end() ? InvalidVertexID : Search->second;
+        }
+
+        bool TagsIndexed() const noexcept{
+            return DIndexTags;
+        }
+
+        void ReserveVertices(std::size_t count) override{
+            CDijkstraPathRouter::ReserveVertices(count);
+            DTags.reserve(count);
+            if(DIndexTags){
+                DTagIndex.reserve(count);
+            }
+        }
+
+        bool ConstructionReport(SConstructionReport &report) const noexcept override{
+            CDijkstraPathRouter::ConstructionReport(report);
+            report.AddComponent("vertex tags",DTags.size(),SConstructionReport::VectorBytes(DTags));
+            if(DIndexTags){
+                report.AddComponent("tag index",DTagIndex.size(),SConstructionReport::HashMapBytes(DTagIndex));
+            }
+            return true;
+        }
 };
 
 #endif
\ No newline at end of file
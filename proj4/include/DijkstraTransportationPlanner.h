@@ -2,6 +2,9 @@
 #define DIJKSTRATRANSPORTATIONPLANNER_H
 
 #include "TransportationPlanner.h"
+#include "PathCache.h"
+#include "SpatialIndex.h"
+#include "DijkstraPathRouter.h"
 
 class CDijkstraTransportationPlanner : public CTransportationPlanner{
     private:
@@ -13,11 +16,35 @@ class CDijkstraTransportationPlanner : public CTransportationPlanner{
 
         std::size_t NodeCount() const noexcept override;
         std::shared_ptr<CStreetMap::SNode> SortedNodeByIndex(std::size_t index) const noexcept override;
+        const CStreetMap::SNode *SortedNodePtrByIndex(std::size_t index) const noexcept override;
 
         double FindShortestPath(TNodeID src, TNodeID dest, std::vector< TNodeID > &path) override;
         double FindFastestPath(TNodeID src, TNodeID dest, std::vector< TTripStep > &path) override;
         bool GetPathDescription(const std::vector< TTripStep > &path, std::vector< std::string > &desc) const override;
-        
+        bool GetPathWays(const std::vector< TNodeID > &path, std::vector< CStreetMap::TWayID > &ways) const override;
+        bool GetPathWayInfo(const std::vector< TNodeID > &path, std::vector< SWayInfo > &info) const override;
+        bool FindIsochrone(TNodeID src, double maxtime, std::vector< std::pair< TNodeID, double > > &reached) override;
+        bool FindTravelTimeTrees(const std::vector< TNodeID > &sources, std::vector< std::vector< double > > &times) override;
+        TNodeID NearestNode(CStreetMap::TLocation loc) const override;
+        double FindShortestPathBetweenLocations(CStreetMap::TLocation src, CStreetMap::TLocation dest, std::vector< TNodeID > &path) override;
+        double FindFastestPathBetweenLocations(CStreetMap::TLocation src, CStreetMap::TLocation dest, std::vector< TTripStep > &path) override;
+        double FindProfilePath(ERoutingProfile profile, TNodeID src, TNodeID dest, std::vector< TNodeID > &path) override;
+        bool ConstructionReports(std::vector< SConstructionReport > &reports) const override;
+
+        // Query result cache, sized by SConfiguration::PathCacheSize
+        CPathCache::SStatistics PathCacheStatistics() const noexcept;
+        void ClearPathCache() noexcept;
+        // Index over the nodes joined by at least one street edge
+        const CSpatialIndex &SpatialIndex() const noexcept;
+        // Router behind FindShortestPath, vertices are tagged with node IDs.
+        // Edges added to it drop every cached path.
+        std::shared_ptr<CDijkstraPathRouter> DistanceRouter() const noexcept;
+        // Search work summed over the routers behind every query, see
+        // CDijkstraPathRouter::SSearchStatistics
+        void SetSearchStatisticsEnabled(bool enable) noexcept;
+        CDijkstraPathRouter::SSearchStatistics SearchStatistics() const noexcept;
+        void ResetSearchStatistics() noexcept;
+
 };
 
 #endif
@@ -0,0 +1,58 @@
+#ifndef MEMORYARENA_H
+#define MEMORYARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+// Monotonic arena for objects that live exactly as long as the container that
+// loaded them. Memory is taken from the heap in a few geometrically growing
+// blocks and handed out by bumping a pointer, deallocation is a no-op and all
+// blocks are released together when the arena is destroyed.
+//
+// Objects made with Create are never destroyed, so they must keep all of
+// their memory in the arena (pmr containers and strings constructed with the
+// arena as their resource).
+class CMemoryArena : public std::pmr::memory_resource{
+    private:
+        // Counts the blocks the arena takes from the heap
+        class CUpstream : public std::pmr::memory_resource{
+            public:
+                std::size_t DBytes = 0;
+                std::size_t DBlocks = 0;
+
+            protected:
+                void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+                void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override;
+                bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+        };
+
+        CUpstream DUpstream;
+        std::pmr::monotonic_buffer_resource DResource;
+        std::size_t DAllocatedBytes = 0;
+
+    protected:
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+    public:
+        explicit CMemoryArena(std::size_t initialsize = 64 * 1024);
+        CMemoryArena(const CMemoryArena &) = delete;
+        CMemoryArena &operator=(const CMemoryArena &) = delete;
+
+        // Constructs a T in the arena, its destructor is never run
+        template <typename T, typename... TArgs>
+        T *Create(TArgs&&... args){
+            return new (allocate(sizeof(T), alignof(T))) T(std::forward<TArgs>(args)...);
+        }
+
+        // Bytes handed out to objects
+        std::size_t AllocatedBytes() const noexcept;
+        // Bytes and blocks taken from the heap
+        std::size_t ReservedBytes() const noexcept;
+        std::size_t BlockCount() const noexcept;
+};
+
+#endif
@@ -19,6 +19,11 @@ class COpenStreetMap : public CStreetMap{
         std::shared_ptr<CStreetMap::SNode> NodeByID(TNodeID id) const noexcept override;
         std::shared_ptr<CStreetMap::SWay> WayByIndex(std::size_t index) const noexcept override;
         std::shared_ptr<CStreetMap::SWay> WayByID(TWayID id) const noexcept override;
+        const CStreetMap::SNode *NodePtrByIndex(std::size_t index) const noexcept override;
+        const CStreetMap::SNode *NodePtrByID(TNodeID id) const noexcept override;
+        const CStreetMap::SWay *WayPtrByIndex(std::size_t index) const noexcept override;
+        const CStreetMap::SWay *WayPtrByID(TWayID id) const noexcept override;
+        bool ConstructionReport(SConstructionReport &report) const noexcept override;
 };
 
 #endif
@@ -0,0 +1,47 @@
+#ifndef PATHCACHE_H
+#define PATHCACHE_H
+
+#include "TransportationPlanner.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Bounded, thread safe LRU cache of planner query results keyed by
+// (src, dest, metric). Paths are stored delta/varint compressed. Entries are
+// tagged with a graph generation and the whole cache is dropped as soon as a
+// lookup or insert presents a different generation.
+class CPathCache{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        using TNodeID = CTransportationPlanner::TNodeID;
+        using TTripStep = CTransportationPlanner::TTripStep;
+
+        enum class EMetric {Distance, Time};
+
+        struct SStatistics{
+            std::size_t DHits = 0;
+            std::size_t DMisses = 0;
+            std::size_t DEvictions = 0;
+            std::size_t DInvalidations = 0;
+            std::size_t DEntries = 0;
+            std::size_t DCompressedBytes = 0;
+        };
+
+        CPathCache(std::size_t capacity);
+        ~CPathCache();
+
+        std::size_t Capacity() const noexcept;
+        SStatistics Statistics() const noexcept;
+        void Clear() noexcept;
+
+        bool Lookup(TNodeID src, TNodeID dest, EMetric metric, std::uint64_t generation, double &cost, std::vector<TTripStep> &path) noexcept;
+        void Insert(TNodeID src, TNodeID dest, EMetric metric, std::uint64_t generation, double cost, const std::vector<TTripStep> &path) noexcept;
+
+        static void EncodePath(const std::vector<TTripStep> &path, std::vector<std::uint8_t> &encoded);
+        static bool DecodePath(const std::vector<std::uint8_t> &encoded, std::vector<TTripStep> &path);
+};
+
+#endif
@@ -5,6 +5,8 @@
 #include <limits>
 #include <any>
 #include <chrono>
+#include <algorithm>
+#include <utility>
 
 class CPathRouter{
     public:
@@ -21,6 +23,72 @@ class CPathRouter{
         virtual bool AddEdge(TVertexID src, TVertexID dest, double weight, bool bidir = false) noexcept = 0;
         virtual bool Precompute(std::chrono::steady_clock::time_point deadline) noexcept = 0;
         virtual double FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path) noexcept = 0;
+
+        // Cheapest path from any source to any target where each seed adds
+        // its non-negative offset to the cost, such as the partial edge from
+        // a location snapped onto a road to the vertex at its end. The graph
+        // itself is left untouched.
+        virtual double FindShortestPathBetweenSets(const std::vector<std::pair<TVertexID, double>> &sources,
+                                                   const std::vector<std::pair<TVertexID, double>> &targets,
+                                                   std::vector<TVertexID> &path) noexcept{
+            double BestCost = NoPathExists;
+            std::vector<TVertexID> Candidate;
+            path.clear();
+            for(const auto &Source : sources){
+                for(const auto &Target : targets){
+                    double Cost = FindShortestPath(Source.first,Target.first,Candidate);
+                    if(Cost != NoPathExists && Source.second + Cost + Target.second < BestCost){
+                        BestCost = Source.second + Cost + Target.second;
+                        path = Candidate;
+                    }
+                }
+            }
+            return BestCost;
+        }
+
+        // One-to-all search from src, dist and prev are sized to VertexCount()
+        // and hold NoPathExists/InvalidVertexID for vertices that are
+        // unreachable or cost more than maxcost.
+        virtual bool FindShortestPathTree(TVertexID src, std::vector<double> &dist, std::vector<TVertexID> &prev, double maxcost = NoPathExists) noexcept{
+            return false;
+        }
+
+        // Vertices reachable from src within maxcost with their costs, in
+        // order of increasing cost.
+        virtual std::size_t FindVerticesWithinCost(TVertexID src, double maxcost, std::vector<std::pair<TVertexID, double>> &reached) noexcept{
+            std::vector<double> Distances;
+            std::vector<TVertexID> Previous;
+            reached.clear();
+            if(!FindShortestPathTree(src,Distances,Previous,maxcost)){
+                return 0;
+            }
+            for(TVertexID Index = 0; Index < Distances.size(); Index++){
+                if(Distances[Index] != NoPathExists){
+                    reached.push_back({Index,Distances[Index]});
+                }
+            }
+            std::stable_sort(reached.begin(),reached.end(),[](const auto &a, const auto &b){ return a.second < b.second; });
+            return reached.size();
+        }
+
+        // Distance arrays from each of several sources, as from
+        // FindShortestPathTree without a cost bound.
+        virtual bool FindShortestPathTrees(const std::vector<TVertexID> &sources, std::vector<std::vector<double>> &dist) noexcept{
+            std::vector<TVertexID> Previous;
+            dist.assign(sources.size(),std::vector<double>());
+            for(std::size_t Index = 0; Index < sources.size(); Index++){
+                if(!FindShortestPathTree(sources[Index],dist[Index],Previous)){
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Changes whenever vertices or edges are added so callers holding
+        // results derived from the graph can tell they are stale.
+        virtual std::size_t ModificationCount() const noexcept{
+            return 0;
+        }
 };
 
 #endif
\ No newline at end of file
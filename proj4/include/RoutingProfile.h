@@ -0,0 +1,152 @@
+#ifndef ROUTINGPROFILE_H
+#define ROUTINGPROFILE_H
+
+#include "StreetMap.h"
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <vector>
+
+// Way attributes the routing profiles base access and cost on, extracted
+// once per way so no tags are parsed while routing.
+struct SRoutingWay{
+    enum : uint8_t {
+        Oneway = 1,         // only open in way node order to vehicles
+        Motorway = 2,       // motorways and their links
+        Steps = 4,
+        FootOnly = 8,       // footways, paths and pedestrian streets
+        NoFoot = 16,
+        NoBicycle = 32,
+        NoWheelchair = 64,
+        NoMotor = 128
+    };
+
+    double DSpeedLimit;
+    uint8_t DFlags;
+
+    static SRoutingWay FromWay(const CStreetMap::SWay &way, double defaultspeed);
+    static double ParseSpeedLimit(const std::string &maxspeed, double defaultspeed);
+
+    bool Has(uint8_t flags) const noexcept{
+        return DFlags & flags;
+    }
+};
+
+struct SRoutingSpeeds{
+    double DWalkSpeed;
+    double DBikeSpeed;
+    double DDefaultSpeedLimit;
+};
+
+// Routing profiles are policies with static Allows and Speed functions,
+// reverse is true when an edge is travelled against its way's node order.
+// The search kernel is instantiated per profile so adding a profile only
+// means adding a policy here.
+struct SPedestrianProfile{
+    static bool Allows(const SRoutingWay &way, bool reverse) noexcept{
+        return !way.Has(SRoutingWay::Motorway | SRoutingWay::NoFoot);
+    }
+    static double Speed(const SRoutingWay &way, const SRoutingSpeeds &speeds) noexcept{
+        return speeds.DWalkSpeed;
+    }
+};
+
+struct SBicycleProfile{
+    static bool Allows(const SRoutingWay &way, bool reverse) noexcept{
+        return !way.Has(SRoutingWay::Motorway | SRoutingWay::Steps | SRoutingWay::FootOnly | SRoutingWay::NoBicycle) &&
+               !(reverse && way.Has(SRoutingWay::Oneway));
+    }
+    static double Speed(const SRoutingWay &way, const SRoutingSpeeds &speeds) noexcept{
+        return speeds.DBikeSpeed;
+    }
+};
+
+struct SCarProfile{
+    static bool Allows(const SRoutingWay &way, bool reverse) noexcept{
+        return !way.Has(SRoutingWay::Steps | SRoutingWay::FootOnly | SRoutingWay::NoMotor) &&
+               !(reverse && way.Has(SRoutingWay::Oneway));
+    }
+    static double Speed(const SRoutingWay &way, const SRoutingSpeeds &speeds) noexcept{
+        return way.DSpeedLimit;
+    }
+};
+
+// Buses drive wherever cars may at the posted limit, stop times are added
+// per leg by the planner
+struct SBusProfile{
+    static bool Allows(const SRoutingWay &way, bool reverse) noexcept{
+        return SCarProfile::Allows(way,reverse);
+    }
+    static double Speed(const SRoutingWay &way, const SRoutingSpeeds &speeds) noexcept{
+        return way.DSpeedLimit;
+    }
+};
+
+// Pedestrian access without steps or ways tagged wheelchair=no
+struct SWheelchairProfile{
+    static bool Allows(const SRoutingWay &way, bool reverse) noexcept{
+        return SPedestrianProfile::Allows(way,reverse) && !way.Has(SRoutingWay::Steps | SRoutingWay::NoWheelchair);
+    }
+    static double Speed(const SRoutingWay &way, const SRoutingSpeeds &speeds) noexcept{
+        return speeds.DWalkSpeed;
+    }
+};
+
+template <typename TProfile>
+double ProfileEdgeCost(const SRoutingWay &way, bool reverse, double distance, const SRoutingSpeeds &speeds) noexcept{
+    if(!TProfile::Allows(way,reverse)){
+        return std::numeric_limits<double>::infinity();
+    }
+    return distance / TProfile::Speed(way,speeds);
+}
+
+// Point to point search over a street graph for one profile. TGraph exposes
+// VertexCount(), EdgeBegin(v), EdgeEnd(v), Target(e), Length(e), Way(e) and
+// Reverse(e). Returns the cost of the path in hours and the vertices along
+// it, or std::numeric_limits<double>::max() if dest cannot be reached.
+template <typename TProfile, typename TGraph>
+double FindProfilePath(const TGraph &graph, const SRoutingSpeeds &speeds, std::size_t src, std::size_t dest, std::vector<std::size_t> &path){
+    const double Unreached = std::numeric_limits<double>::infinity();
+    const std::size_t NoVertex = std::numeric_limits<std::size_t>::max();
+    path.clear();
+    if(src >= graph.VertexCount() || dest >= graph.VertexCount()){
+        return std::numeric_limits<double>::max();
+    }
+    using TEntry = std::pair<double, std::size_t>;
+    std::priority_queue<TEntry, std::vector<TEntry>, std::greater<TEntry>> Queue;
+    std::vector<double> Distances(graph.VertexCount(),Unreached);
+    std::vector<std::size_t> Previous(graph.VertexCount(),NoVertex);
+    Distances[src] = 0.0;
+    Queue.push({0.0,src});
+    while(!Queue.empty()){
+        auto [Distance, Current] = Queue.top();
+        Queue.pop();
+        if(Distance > Distances[Current]){
+            continue;
+        }
+        if(Current == dest){
+            break;
+        }
+        for(auto Edge = graph.EdgeBegin(Current); Edge < graph.EdgeEnd(Current); Edge++){
+            double Alternate = Distance + ProfileEdgeCost<TProfile>(graph.Way(Edge),graph.Reverse(Edge),graph.Length(Edge),speeds);
+            auto Target = graph.Target(Edge);
+            if(Alternate < Distances[Target]){
+                Distances[Target] = Alternate;
+                Previous[Target] = Current;
+                Queue.push({Alternate,Target});
+            }
+        }
+    }
+    if(Distances[dest] == Unreached){
+        return std::numeric_limits<double>::max();
+    }
+    for(std::size_t Vertex = dest; Vertex != NoVertex; Vertex = Previous[Vertex]){
+        path.push_back(Vertex);
+    }
+    std::reverse(path.begin(),path.end());
+    return Distances[dest];
+}
+
+#endif
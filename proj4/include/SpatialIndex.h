@@ -0,0 +1,67 @@
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+#include "StreetMap.h"
+#include <memory>
+#include <vector>
+
+// Static packed R-tree over node locations, bulk loaded by sort tile
+// recursive packing in O(n log n). Distances are Haversine miles.
+class CSpatialIndex{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        using TNodeID = CStreetMap::TNodeID;
+        using TLocation = CStreetMap::TLocation;
+
+        CSpatialIndex(const std::vector< std::pair< TNodeID, TLocation > > &nodes);
+        CSpatialIndex(std::shared_ptr<CStreetMap> streetmap);
+        ~CSpatialIndex();
+
+        std::size_t NodeCount() const noexcept;
+        std::size_t MemoryUsage() const noexcept;
+        // Closest node to loc, InvalidNodeID if the index is empty
+        TNodeID NearestNode(TLocation loc) const noexcept;
+        // Up to count closest nodes with their distances, nearest first
+        std::size_t NearestNodes(TLocation loc, std::size_t count, std::vector< std::pair< TNodeID, double > > &nodes) const;
+        // Nodes within radius miles of loc with their distances, nearest first
+        std::size_t NodesWithinRadius(TLocation loc, double radius, std::vector< std::pair< TNodeID, double > > &nodes) const;
+};
+
+// Static packed R-tree over straight segments between two locations, such as
+// road segments, for snapping a location onto the closest point of a road.
+class CSegmentIndex{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        using TLocation = CStreetMap::TLocation;
+
+        struct SSegment{
+            TLocation DStart;
+            TLocation DEnd;
+        };
+
+        // Closest point on a segment, DFraction runs from 0 at DStart to 1 at
+        // DEnd and DDistance is in Haversine miles
+        struct SMatch{
+            std::size_t DSegment;
+            double DFraction;
+            TLocation DLocation;
+            double DDistance;
+        };
+
+        CSegmentIndex(const std::vector< SSegment > &segments);
+        ~CSegmentIndex();
+
+        std::size_t SegmentCount() const noexcept;
+        std::size_t MemoryUsage() const noexcept;
+        bool NearestSegment(TLocation loc, SMatch &match) const;
+        // Up to count closest segments, nearest first
+        std::size_t NearestSegments(TLocation loc, std::size_t count, std::vector< SMatch > &matches) const;
+};
+
+#endif
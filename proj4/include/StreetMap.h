@@ -6,6 +6,7 @@
 #include <string>
 #include <utility>
 #include <limits>
+#include "ConstructionReport.h"
 
 class CStreetMap{
     public:
@@ -45,6 +46,28 @@ class CStreetMap{
         virtual std::shared_ptr<SNode> NodeByID(TNodeID id) const noexcept = 0;
         virtual std::shared_ptr<SWay> WayByIndex(std::size_t index) const noexcept = 0;
         virtual std::shared_ptr<SWay> WayByID(TWayID id) const noexcept = 0;
+
+        // Non-owning lookups for hot loops, they skip the reference count and
+        // stay valid for as long as the map does. The defaults are only safe
+        // for maps that keep the objects they hand out, maps that create them
+        // on demand must override these.
+        virtual const SNode *NodePtrByIndex(std::size_t index) const noexcept{
+            return NodeByIndex(index).get();
+        }
+        virtual const SNode *NodePtrByID(TNodeID id) const noexcept{
+            return NodeByID(id).get();
+        }
+        virtual const SWay *WayPtrByIndex(std::size_t index) const noexcept{
+            return WayByIndex(index).get();
+        }
+        virtual const SWay *WayPtrByID(TWayID id) const noexcept{
+            return WayByID(id).get();
+        }
+
+        // Load time and memory profile, false if the map does not keep one
+        virtual bool ConstructionReport(SConstructionReport &report) const noexcept{
+            return false;
+        }
 };
 
 #endif
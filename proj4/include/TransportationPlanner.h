@@ -4,12 +4,25 @@
 #include "StreetMap.h"
 #include "BusSystem.h"
 #include "PathRouter.h"
+#include "BusPathStore.h"
 
 class CTransportationPlanner{
     public:
         using TNodeID = CStreetMap::TNodeID;
         enum class ETransportationMode {Walk, Bike, Bus};
         using TTripStep = std::pair<ETransportationMode, TNodeID>;
+        // Order router vertices are numbered in, Hilbert keeps geographically
+        // close nodes close in memory
+        enum class EVertexOrder {NodeID, Hilbert};
+        // Single mode street routing profiles, see RoutingProfile.h
+        enum class ERoutingProfile {Pedestrian, Bicycle, Bus, Car, Wheelchair};
+
+        struct SWayInfo{
+            CStreetMap::TWayID DWayID;
+            std::string DName;
+            std::string DMaxSpeed;
+            std::string DHighway;
+        };
 
         struct SConfiguration{
             virtual ~SConfiguration(){};
@@ -20,16 +33,99 @@ class CTransportationPlanner{
             virtual double DefaultSpeedLimit() const noexcept = 0;
             virtual double BusStopTime() const noexcept = 0;
             virtual int PrecomputeTime() const noexcept = 0;
+            virtual std::shared_ptr<CBusPathStore> BusPaths() const noexcept{
+                return nullptr;
+            }
+            // Maximum number of cached query results, zero disables caching
+            virtual std::size_t PathCacheSize() const noexcept{
+                return 0;
+            }
+            // Fixed point units per mile for shortest path searches (e.g.
+            // 160934.4 for centimetres), zero searches on doubles
+            virtual double DistanceFixedPointScale() const noexcept{
+                return 0.0;
+            }
+            virtual EVertexOrder VertexOrder() const noexcept{
+                return EVertexOrder::NodeID;
+            }
         };
 
         virtual ~CTransportationPlanner(){};
 
         virtual std::size_t NodeCount() const noexcept = 0;
         virtual std::shared_ptr<CStreetMap::SNode> SortedNodeByIndex(std::size_t index) const noexcept = 0;
+        // Non-owning form of SortedNodeByIndex valid for as long as the
+        // planner, the default is only safe for planners that keep the nodes
+        virtual const CStreetMap::SNode *SortedNodePtrByIndex(std::size_t index) const noexcept{
+            return SortedNodeByIndex(index).get();
+        }
 
         virtual double FindShortestPath(TNodeID src, TNodeID dest, std::vector< TNodeID > &path) = 0;
         virtual double FindFastestPath(TNodeID src, TNodeID dest, std::vector< TTripStep > &path) = 0;
         virtual bool GetPathDescription(const std::vector< TTripStep > &path, std::vector< std::string > &desc) const = 0;
+
+        // Way lookups for consecutive path nodes, one entry per segment with
+        // InvalidWayID where two nodes are not joined by a way. Returns false
+        // if any segment could not be resolved.
+        virtual bool GetPathWays(const std::vector< TNodeID > &path, std::vector< CStreetMap::TWayID > &ways) const{
+            return false;
+        }
+        virtual bool GetPathWayInfo(const std::vector< TNodeID > &path, std::vector< SWayInfo > &info) const{
+            return false;
+        }
+
+        // Nodes reachable from src within maxtime hours on the travel time
+        // graph with their times, in order of increasing time.
+        virtual bool FindIsochrone(TNodeID src, double maxtime, std::vector< std::pair< TNodeID, double > > &reached){
+            return false;
+        }
+
+        // Travel times in hours from each source to every node, indexed like
+        // SortedNodeByIndex with CPathRouter::NoPathExists if unreachable.
+        virtual bool FindTravelTimeTrees(const std::vector< TNodeID > &sources, std::vector< std::vector< double > > &times){
+            return false;
+        }
+
+        // Closest node on the street graph to a location, InvalidNodeID if
+        // there is none.
+        virtual TNodeID NearestNode(CStreetMap::TLocation loc) const{
+            return CStreetMap::InvalidNodeID;
+        }
+
+        // Paths between arbitrary locations, such as GPS fixes. By default
+        // each is snapped to its nearest node and the cost covers the path
+        // between those nodes, planners able to snap onto the closest point
+        // of a road include the partial roads at either end.
+        virtual double FindShortestPathBetweenLocations(CStreetMap::TLocation src, CStreetMap::TLocation dest, std::vector< TNodeID > &path){
+            path.clear();
+            TNodeID SrcID = NearestNode(src);
+            TNodeID DestID = NearestNode(dest);
+            if(SrcID == CStreetMap::InvalidNodeID || DestID == CStreetMap::InvalidNodeID){
+                return CPathRouter::NoPathExists;
+            }
+            return FindShortestPath(SrcID,DestID,path);
+        }
+        virtual double FindFastestPathBetweenLocations(CStreetMap::TLocation src, CStreetMap::TLocation dest, std::vector< TTripStep > &path){
+            path.clear();
+            TNodeID SrcID = NearestNode(src);
+            TNodeID DestID = NearestNode(dest);
+            if(SrcID == CStreetMap::InvalidNodeID || DestID == CStreetMap::InvalidNodeID){
+                return CPathRouter::NoPathExists;
+            }
+            return FindFastestPath(SrcID,DestID,path);
+        }
+
+        // Fastest street path for one profile, returns the time in hours or
+        // CPathRouter::NoPathExists.
+        virtual double FindProfilePath(ERoutingProfile profile, TNodeID src, TNodeID dest, std::vector< TNodeID > &path){
+            return CPathRouter::NoPathExists;
+        }
+
+        // Load time and memory profiles of the planner and the data it was
+        // built from, false if none are kept.
+        virtual bool ConstructionReports(std::vector< SConstructionReport > &reports) const{
+            return false;
+        }
 };
 
 #endif
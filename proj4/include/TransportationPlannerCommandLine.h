@@ -14,6 +14,10 @@ class CTransportationPlannerCommandLine{
         CTransportationPlannerCommandLine(std::shared_ptr<CDataSource> cmdsrc, std::shared_ptr<CDataSink> outsink, std::shared_ptr<CDataSink> errsink, std::shared_ptr<CDataFactory> results, std::shared_ptr<CTransportationPlanner> planner);
         ~CTransportationPlannerCommandLine();
         bool ProcessCommands();
+        // Non-interactive mode, path queries run on a pool of worker threads
+        // (hardware concurrency when workers is zero) while results are
+        // written in input order without prompts.
+        bool ProcessBatchCommands(std::size_t workers = 0);
 };
 
 #endif
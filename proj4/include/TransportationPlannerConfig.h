@@ -11,6 +11,10 @@ struct STransportationPlannerConfig : public CTransportationPlanner::SConfigurat
     double DDefaultSpeedLimit;
     double DBusStopTime;
     int DPrecomputeTime;
+    std::shared_ptr<CBusPathStore> DBusPaths;
+    std::size_t DPathCacheSize;
+    double DDistanceFixedPointScale;
+    CTransportationPlanner::EVertexOrder DVertexOrder;
 
     STransportationPlannerConfig(   std::shared_ptr<CStreetMap> streetmap, 
                                     std::shared_ptr<CBusSystem> bussystem,
@@ -18,7 +22,11 @@ struct STransportationPlannerConfig : public CTransportationPlanner::SConfigurat
                                     double bikespeed = 8.0,
                                     double speedlimit = 25.0,
                                     double busstoptime = 30.0,
-                                    int precompute = 30){
+                                    int precompute = 30,
+                                    std::shared_ptr<CBusPathStore> buspaths = nullptr,
+                                    std::size_t pathcachesize = 0,
+                                    double distancescale = 0.0,
+                                    CTransportationPlanner::EVertexOrder vertexorder = CTransportationPlanner::EVertexOrder::NodeID){
         DStreetMap = streetmap;
         DBusSystem = bussystem;
         DWalkSpeed = walkspeed;
@@ -26,6 +34,10 @@ struct STransportationPlannerConfig : public CTransportationPlanner::SConfigurat
         DDefaultSpeedLimit = speedlimit;
         DBusStopTime = busstoptime;
         DPrecomputeTime = precompute;
+        DBusPaths = buspaths;
+        DPathCacheSize = pathcachesize;
+        DDistanceFixedPointScale = distancescale;
+        DVertexOrder = vertexorder;
 
     }
 
@@ -56,6 +68,22 @@ struct STransportationPlannerConfig : public CTransportationPlanner::SConfigurat
     int PrecomputeTime() const noexcept{
         return DPrecomputeTime;
     }
+
+    std::shared_ptr<CBusPathStore> BusPaths() const noexcept{
+        return DBusPaths;
+    }
+
+    std::size_t PathCacheSize() const noexcept{
+        return DPathCacheSize;
+    }
+
+    double DistanceFixedPointScale() const noexcept{
+        return DDistanceFixedPointScale;
+    }
+
+    CTransportationPlanner::EVertexOrder VertexOrder() const noexcept{
+        return DVertexOrder;
+    }
 };
 
 #endif
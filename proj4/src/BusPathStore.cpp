@@ -0,0 +1,142 @@
+#include "BusPathStore.h"
+#include <unordered_map>
+
+struct CBusPathStore::SImplementation{
+    struct SSegment{
+        std::size_t DOffset;
+        std::size_t DCount;
+        std::vector<std::string> DRoutes;
+    };
+
+    struct SNodePairHash{
+        std::size_t operator()(const std::pair<TNodeID, TNodeID> &key) const noexcept{
+            return std::hash<TNodeID>()(key.first) ^ (std::hash<TNodeID>()(key.second) * 0x9E3779B97F4A7C15ULL);
+        }
+    };
+
+    // All paths share one flat node array, segments only keep offsets into it
+    std::vector<TNodeID> DNodes;
+    std::vector<SSegment> DSegments;
+    std::unordered_map<std::pair<TNodeID, TNodeID>, std::size_t, SNodePairHash> DSegmentIndices;
+
+    static bool ParseNodeID(const std::string &str, TNodeID &id){
+        if(str.empty()){
+            return false;
+        }
+        TNodeID Value = 0;
+        for(char Ch : str){
+            if(Ch < '0' || Ch > '9'){
+                return false;
+            }
+            Value = Value * 10 + (Ch - '0');
+        }
+        id = Value;
+        return true;
+    }
+
+    SImplementation(std::shared_ptr<CDSVReader> src){
+        std::vector<std::string> Row;
+        if(!src){
+            return;
+        }
+        while(src->ReadRow(Row)){
+            TNodeID SrcID, DestID;
+            // header row and malformed rows fail to parse and are skipped
+            if(Row.size() < 4 || !ParseNodeID(Row[0],SrcID) || !ParseNodeID(Row[1],DestID)){
+                continue;
+            }
+            SSegment Segment;
+            Segment.DOffset = DNodes.size();
+            const std::string &PathString = Row[3];
+            std::size_t Start = 0;
+            bool Valid = true;
+            while(Start <= PathString.size()){
+                std::size_t End = PathString.find(',',Start);
+                if(End == std::string::npos){
+                    End = PathString.size();
+                }
+                TNodeID NodeID;
+                if(!ParseNodeID(PathString.substr(Start,End - Start),NodeID)){
+                    Valid = false;
+                    break;
+                }
+                DNodes.push_back(NodeID);
+                Start = End + 1;
+            }
+            Segment.DCount = DNodes.size() - Segment.DOffset;
+            if(!Valid || Segment.DCount < 2 || DNodes[Segment.DOffset] != SrcID || DNodes.back() != DestID){
+                DNodes.resize(Segment.DOffset);
+                continue;
+            }
+            std::size_t RouteStart = 0;
+            const std::string &RouteString = Row[2];
+            while(RouteStart < RouteString.size()){
+                std::size_t RouteEnd = RouteString.find('_',RouteStart);
+                if(RouteEnd == std::string::npos){
+                    RouteEnd = RouteString.size();
+                }
+                if(RouteEnd > RouteStart){
+                    Segment.DRoutes.push_back(RouteString.substr(RouteStart,RouteEnd - RouteStart));
+                }
+                RouteStart = RouteEnd + 1;
+            }
+            auto Search = DSegmentIndices.find({SrcID,DestID});
+            if(Search != DSegmentIndices.end()){
+                // Duplicate rows keep the first geometry seen
+                DNodes.resize(Segment.DOffset);
+                continue;
+            }
+            DSegmentIndices[{SrcID,DestID}] = DSegments.size();
+            DSegments.push_back(std::move(Segment));
+        }
+        DNodes.shrink_to_fit();
+        DSegments.shrink_to_fit();
+    }
+
+    const SSegment *FindSegment(TNodeID src, TNodeID dest) const{
+        auto Search = DSegmentIndices.find({src,dest});
+        if(Search == DSegmentIndices.end()){
+            return nullptr;
+        }
+        return &DSegments[Search->second];
+    }
+};
+
+CBusPathStore::CBusPathStore(std::shared_ptr<CDSVReader> src){
+    DImplementation = std::make_unique<SImplementation>(src);
+}
+
+CBusPathStore::~CBusPathStore(){
+
+}
+
+std::size_t CBusPathStore::SegmentCount() const noexcept{
+    return DImplementation->DSegments.size();
+}
+
+std::size_t CBusPathStore::PathNodeCount() const noexcept{
+    return DImplementation->DNodes.size();
+}
+
+bool CBusPathStore::HasPath(TNodeID src, TNodeID dest) const noexcept{
+    return DImplementation->FindSegment(src,dest) != nullptr;
+}
+
+bool CBusPathStore::GetPath(TNodeID src, TNodeID dest, std::vector<TNodeID> &path) const noexcept{
+    path.clear();
+    auto Segment = DImplementation->FindSegment(src,dest);
+    if(!Segment){
+        return false;
+    }
+    auto Begin = DImplementation->DNodes.begin() + Segment->DOffset;
+    path.assign(Begin,Begin + Segment->DCount);
+    return true;
+}
+
+std::vector<std::string> CBusPathStore::GetRoutes(TNodeID src, TNodeID dest) const noexcept{
+    auto Segment = DImplementation->FindSegment(src,dest);
+    if(!Segment){
+        return {};
+    }
+    return Segment->DRoutes;
+}
@@ -6,11 +6,15 @@
 #include <vector>                   // To store lists of stops and routes
 #include <algorithm>                // To sort stops and routes
 #include <unordered_set>            // For storing sets of routes
+#include <unordered_map>            // For looking up stops by node ID
 
 struct CBusSystemIndexer::SImplementation {
     // Internal pointer to the bus system.
     std::shared_ptr<CBusSystem> busSystemPtr;
 
+    // Stop at each node, the last one listed when a node has several.
+    std::unordered_map<TNodeID, std::shared_ptr<CBusSystem::SStop>> stopsByNodeID;
+
     // Constructor.
     SImplementation(std::shared_ptr<CBusSystem> bs);
 
@@ -83,7 +87,13 @@ bool CBusSystemIndexer::RouteBetweenNodeIDs(TNodeID src, TNodeID dest) const noe
 
 // Definitions of SImplementation functions
 CBusSystemIndexer::SImplementation::SImplementation(std::shared_ptr<CBusSystem> bs)
-    : busSystemPtr(bs) {}
+    : busSystemPtr(bs) {
+    for (std::size_t i = 0; i < busSystemPtr->StopCount(); ++i) {
+        auto stop = busSystemPtr->StopByIndex(i);
+        if (stop)
+            stopsByNodeID[stop->NodeID()] = stop;
+    }
+}
 
 std::size_t CBusSystemIndexer::SImplementation::StopCount() const {
     return busSystemPtr->StopCount();
@@ -98,7 +108,7 @@ std::shared_ptr<CBusSystem::SStop> CBusSystemIndexer::SImplementation::SortedSto
         return nullptr;
     std::vector<CBusSystem::TStopID> sortedStopIDs;
     for (std::size_t i = 0; i < busSystemPtr->StopCount(); ++i) {
-        auto stop = busSystemPtr->StopByIndex(i);
+        auto stop = busSystemPtr->StopPtrByIndex(i);
         if (stop)
             sortedStopIDs.push_back(stop->ID());
     }
@@ -115,7 +125,7 @@ std::shared_ptr<CBusSystem::SRoute> CBusSystemIndexer::SImplementation::SortedRo
     }
     std::vector<std::string> routeNames;
     for (std::size_t i = 0; i < busSystemPtr->RouteCount(); ++i) {
-        auto route = busSystemPtr->RouteByIndex(i);
+        auto route = busSystemPtr->RoutePtrByIndex(i);
         if (route)
             routeNames.push_back(route->Name());
     }
@@ -126,14 +136,10 @@ std::shared_ptr<CBusSystem::SRoute> CBusSystemIndexer::SImplementation::SortedRo
 }
 
 std::shared_ptr<CBusSystem::SStop> CBusSystemIndexer::SImplementation::StopByNodeID(TNodeID nodeId) const {
-    std::shared_ptr<CBusSystem::SStop> output = nullptr;
-    for (std::size_t i = 0; i < busSystemPtr->StopCount(); ++i) {
-        auto stop = busSystemPtr->StopByIndex(i);
-        if (stop && stop->NodeID() == nodeId) {
-            output = stop;
-        }
-    }
-    return output;
+    auto search = stopsByNodeID.find(nodeId);
+    if (search == stopsByNodeID.end())
+        return nullptr;
+    return search->second;
 }
 
 bool CBusSystemIndexer::SImplementation::RoutesByNodeIDs(TNodeID src, TNodeID dest,
@@ -148,7 +154,7 @@ bool CBusSystemIndexer::SImplementation::RoutesByNodeIDs(TNodeID src, TNodeID de
     CBusSystem::TStopID destID = destStop->ID();
 
     for (std::size_t i = 0; i < busSystemPtr->RouteCount(); ++i) {
-        auto route = busSystemPtr->RouteByIndex(i);
+        auto route = busSystemPtr->RoutePtrByIndex(i);
         if (!route) {
             continue;
         }
@@ -161,7 +167,7 @@ bool CBusSystemIndexer::SImplementation::RoutesByNodeIDs(TNodeID src, TNodeID de
                 hasDest = 1;
             }
             if (hasSrc + hasDest == 2) {
-                outRoutes.insert(route);
+                outRoutes.insert(busSystemPtr->RouteByIndex(i));
                 break;
             }
         }
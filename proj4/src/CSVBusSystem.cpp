@@ -1,10 +1,14 @@
 #include "CSVBusSystem.h"
 #include "DSVReader.h"
+#include "MemoryArena.h"
 #include <vector>
 #include <memory>
 #include <iostream>   
 #include <string>
 #include <unordered_map>
+#include <memory_resource>
+#include <algorithm>
+#include <chrono>
 
 class CCSVBusSystem::SStop : public CBusSystem::SStop {
 public:
@@ -19,10 +23,12 @@ public:
 
 struct CCSVBusSystem::SRoute : public CBusSystem::SRoute {
 public:
-    std::string name_;
-    std::vector<TStopID> stopIds_;  
+    std::pmr::string name_;
+    std::pmr::vector<TStopID> stopIds_;  
 
-    std::string Name() const noexcept override { return name_; }
+    explicit SRoute(std::pmr::memory_resource *arena) : name_(arena), stopIds_(arena) {}
+
+    std::string Name() const noexcept override { return std::string(name_); }
 
     std::size_t StopCount() const noexcept override { return stopIds_.size(); }
 
@@ -36,25 +42,31 @@ public:
 };
 
 struct CCSVBusSystem::SImplementation {
-    // ... SImplementation members ...
-    std::vector<std::shared_ptr<SStop>> stops;
-    std::unordered_map<TStopID, std::shared_ptr<SStop>> stopmap;
-    std::vector<std::shared_ptr<SRoute>> routes;
-    std::unordered_map<std::string, std::shared_ptr<SRoute>> routemap;  
+    // Stops and routes are allocated in the arena, handed out pointers share
+    // ownership of it so they outlive the bus system. The index maps stay on
+    // the heap, the arena never gets back the buckets a rehash drops.
+    std::shared_ptr<CMemoryArena> arena = std::make_shared<CMemoryArena>(4 * 1024);
+    std::vector<SStop *> stops;
+    std::unordered_map<TStopID, SStop *> stopmap;
+    std::vector<SRoute *> routes;
+    std::unordered_map<std::string, SRoute *> routemap;
+    SConstructionReport report;
     //SImplementation() {} 
 };
 
 CCSVBusSystem::CCSVBusSystem(std::shared_ptr<CDSVReader> stopsrc, std::shared_ptr<CDSVReader> routesrc)    
     : DImplementation(std::make_unique<SImplementation>()) {
     std::vector<std::string> row;  
-
+    SConstructionReport::CPhaseTimer timer(DImplementation->report);
 
     if (stopsrc) {
         while (stopsrc->ReadRow(row)) {
             try {
-                auto stop = std::make_shared<SStop>();
-                stop->id_ = std::stoul(row[0]);  
-                stop->nodeId_ = std::stoul(row[1]);
+                TStopID stopID = std::stoul(row[0]);  
+                CStreetMap::TNodeID nodeID = std::stoul(row[1]);
+                auto stop = DImplementation->arena->Create<SStop>();
+                stop->id_ = stopID;
+                stop->nodeId_ = nodeID;
                 DImplementation->stopmap.emplace(stop->id_, stop);
                 DImplementation->stops.emplace_back(stop);  
             } catch (const std::exception& e) {
@@ -62,20 +74,18 @@ CCSVBusSystem::CCSVBusSystem(std::shared_ptr<CDSVReader> stopsrc, std::shared_pt
             }
         }
     }
+    timer.Lap("read stops");
 
     if (routesrc) {
-        std::unordered_map<std::string, std::shared_ptr<SRoute>> temporaryRoutes;  
+        // Stop lists are gathered on the heap and copied into the arena at
+        // their final size
+        std::unordered_map<std::string, std::vector<TStopID>> temporaryRoutes;  
         while (routesrc->ReadRow(row)) {  
             if (row.size() >= 2) {  
                 try {
                     std::string routeName = row[0];  
                     TStopID stopID = std::stoul(row[1]);  
-                    auto& route = temporaryRoutes[routeName];  
-                    if (!route) {
-                        route = std::make_shared<SRoute>();
-                        route->name_ = routeName;
-                    }
-                    route->stopIds_.push_back(stopID);  
+                    temporaryRoutes[routeName].push_back(stopID);  
                 } catch (const std::exception& e) {
                     //handle error
                     std::cerr << "exception caught: " << e.what() << "\n";
@@ -83,16 +93,47 @@ CCSVBusSystem::CCSVBusSystem(std::shared_ptr<CDSVReader> stopsrc, std::shared_pt
             }
         }
 
+        auto &arena = *DImplementation->arena;
+        DImplementation->routemap.reserve(temporaryRoutes.size());
+        DImplementation->routes.reserve(temporaryRoutes.size());
         for (auto it = temporaryRoutes.begin(); it != temporaryRoutes.end(); ++it) {
-            DImplementation->routemap[it->first] = it->second;
-            DImplementation->routes.push_back(it->second);  
+            auto route = arena.Create<SRoute>(&arena);
+            route->name_ = it->first;
+            route->stopIds_.assign(it->second.begin(), it->second.end());
+            DImplementation->routemap.emplace(it->first, route);
+            DImplementation->routes.push_back(route);  
         }
     }
+    timer.Lap("read routes");
 }
 
 // Destructor
 CCSVBusSystem::~CCSVBusSystem() = default;
 
+bool CCSVBusSystem::ConstructionReport(SConstructionReport &report) const noexcept {
+    const auto &impl = *DImplementation;
+    report = SConstructionReport();
+    report.DName = "CCSVBusSystem";
+    report.DPhases = impl.report.DPhases;
+    report.AddComponent("stops", impl.stops.size(), SConstructionReport::VectorBytes(impl.stops) +
+                        impl.stops.size() * sizeof(SStop) +
+                        SConstructionReport::HashMapBytes(impl.stopmap));
+    std::size_t routeBytes = SConstructionReport::VectorBytes(impl.routes) + SConstructionReport::HashMapBytes(impl.routemap);
+    std::size_t routeStops = 0, routeStopBytes = 0;
+    for (const auto &route : impl.routes) {
+        routeBytes += sizeof(SRoute) + SConstructionReport::StringBytes(route->name_);
+        routeStops += route->stopIds_.size();
+        routeStopBytes += SConstructionReport::VectorBytes(route->stopIds_);
+    }
+    for (const auto &entry : impl.routemap)
+        routeBytes += SConstructionReport::StringBytes(entry.first);
+    report.AddComponent("routes", impl.routes.size(), routeBytes);
+    report.AddComponent("route stops", routeStops, routeStopBytes);
+    report.AddComponent("arena slack", impl.arena->BlockCount(),
+                        impl.arena->ReservedBytes() - std::min(impl.arena->AllocatedBytes(), impl.arena->ReservedBytes()));
+    return true;
+}
+
 std::size_t CCSVBusSystem::StopCount() const noexcept {
     return DImplementation->stops.size();
 }
@@ -106,7 +147,7 @@ std::shared_ptr<CBusSystem::SStop> CCSVBusSystem::StopByIndex(std::size_t index)
     if (index >= DImplementation->stops.size()) {
         return nullptr;
     } else {
-        return DImplementation->stops[index];
+        return std::shared_ptr<CBusSystem::SStop>(DImplementation->arena, DImplementation->stops[index]);
     }
 }
 
@@ -114,7 +155,7 @@ std::shared_ptr<CBusSystem::SStop> CCSVBusSystem::StopByIndex(std::size_t index)
 std::shared_ptr<CBusSystem::SStop> CCSVBusSystem::StopByID(TStopID id) const noexcept {
     auto it = DImplementation->stopmap.find(id);
     if (it != DImplementation->stopmap.end()) {
-        return it->second;
+        return std::shared_ptr<CBusSystem::SStop>(DImplementation->arena, it->second);
     }
     return nullptr;
 }
@@ -124,18 +165,37 @@ std::shared_ptr<CBusSystem::SRoute> CCSVBusSystem::RouteByIndex(std::size_t inde
     if (index >= DImplementation->routes.size()) {
         return nullptr;
     } else {
-        return DImplementation->routes[index];
+        return std::shared_ptr<CBusSystem::SRoute>(DImplementation->arena, DImplementation->routes[index]);
     }
 }
 
 std::shared_ptr<CBusSystem::SRoute> CCSVBusSystem::RouteByName(const std::string &name) const noexcept {
     auto it = DImplementation->routemap.find(name);
     if (it != DImplementation->routemap.end()) {
-        return it->second;
+        return std::shared_ptr<CBusSystem::SRoute>(DImplementation->arena, it->second);
     }
     return nullptr;
 }
 
+// Non-owning lookups, the shared versions above alias the arena instead
+const CBusSystem::SStop *CCSVBusSystem::StopPtrByIndex(std::size_t index) const noexcept {
+    return index < DImplementation->stops.size() ? DImplementation->stops[index] : nullptr;
+}
+
+const CBusSystem::SStop *CCSVBusSystem::StopPtrByID(TStopID id) const noexcept {
+    auto it = DImplementation->stopmap.find(id);
+    return it != DImplementation->stopmap.end() ? it->second : nullptr;
+}
+
+const CBusSystem::SRoute *CCSVBusSystem::RoutePtrByIndex(std::size_t index) const noexcept {
+    return index < DImplementation->routes.size() ? DImplementation->routes[index] : nullptr;
+}
+
+const CBusSystem::SRoute *CCSVBusSystem::RoutePtrByName(const std::string &name) const noexcept {
+    auto it = DImplementation->routemap.find(name);
+    return it != DImplementation->routemap.end() ? it->second : nullptr;
+}
+
 // CCSVBusSystem member functions
 // Constructor for the CSV Bus System
     //CCSVBusSystem(std::shared_ptr< CDSVReader > stopsrc, std::shared_ptr< CDSVReader > routesrc);
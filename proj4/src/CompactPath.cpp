@@ -0,0 +1,93 @@
+#include "CompactPath.h"
+
+CCompactPath::CCompactPath(const std::vector<TNodeID> &path){
+    Encode(path);
+}
+
+void CCompactPath::Encode(const std::vector<TNodeID> &path){
+    DBytes.clear();
+    TNodeID Previous = 0;
+    for(auto NodeID : path){
+        WriteDelta(Previous,NodeID,DBytes);
+        Previous = NodeID;
+    }
+    DBytes.shrink_to_fit();
+    DNodeCount = path.size();
+}
+
+bool CCompactPath::Decode(std::vector<TNodeID> &path) const{
+    path.resize(DNodeCount);
+    TNodeID Previous = 0;
+    std::size_t Index = 0;
+    for(auto &NodeID : path){
+        if(!ReadDelta(DBytes,Index,Previous)){
+            path.clear();
+            return false;
+        }
+        NodeID = Previous;
+    }
+    return true;
+}
+
+void CCompactPath::Clear() noexcept{
+    DBytes.clear();
+    DNodeCount = 0;
+}
+
+bool CCompactPath::Empty() const noexcept{
+    return !DNodeCount;
+}
+
+std::size_t CCompactPath::NodeCount() const noexcept{
+    return DNodeCount;
+}
+
+std::size_t CCompactPath::ByteCount() const noexcept{
+    return DBytes.size();
+}
+
+const std::vector<std::uint8_t> &CCompactPath::Bytes() const noexcept{
+    return DBytes;
+}
+
+bool CCompactPath::operator==(const CCompactPath &other) const noexcept{
+    return DNodeCount == other.DNodeCount && DBytes == other.DBytes;
+}
+
+void CCompactPath::WriteVarint(std::uint64_t value, std::vector<std::uint8_t> &encoded){
+    while(value >= 0x80){
+        encoded.push_back(static_cast<std::uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    encoded.push_back(static_cast<std::uint8_t>(value));
+}
+
+bool CCompactPath::ReadVarint(const std::vector<std::uint8_t> &encoded, std::size_t &index, std::uint64_t &value){
+    value = 0;
+    for(unsigned Shift = 0; Shift < 64; Shift += 7){
+        if(index >= encoded.size()){
+            return false;
+        }
+        std::uint8_t Byte = encoded[index++];
+        value |= static_cast<std::uint64_t>(Byte & 0x7F) << Shift;
+        if(!(Byte & 0x80)){
+            return true;
+        }
+    }
+    return false;
+}
+
+// Deltas wrap around, so any pair of IDs round trips
+void CCompactPath::WriteDelta(TNodeID previous, TNodeID current, std::vector<std::uint8_t> &encoded){
+    std::int64_t Delta = static_cast<std::int64_t>(current - previous);
+    WriteVarint((static_cast<std::uint64_t>(Delta) << 1) ^ static_cast<std::uint64_t>(Delta >> 63),encoded);
+}
+
+bool CCompactPath::ReadDelta(const std::vector<std::uint8_t> &encoded, std::size_t &index, TNodeID &current){
+    std::uint64_t ZigZag;
+    if(!ReadVarint(encoded,index,ZigZag)){
+        return false;
+    }
+    current += static_cast<TNodeID>((ZigZag >> 1) ^ (~(ZigZag & 1) + 1));
+    return true;
+}
@@ -0,0 +1,56 @@
+#include "ConstructionReport.h"
+#include <iomanip>
+#include <sstream>
+
+void SConstructionReport::AddPhase(const std::string &name, std::chrono::nanoseconds time){
+    DPhases.push_back({name,time});
+}
+
+void SConstructionReport::AddComponent(const std::string &name, std::size_t count, std::size_t bytes){
+    DComponents.push_back({name,count,bytes});
+}
+
+void SConstructionReport::AddComponents(const SConstructionReport &other){
+    for(auto &Component : other.DComponents){
+        AddComponent(other.DName + " " + Component.DName,Component.DCount,Component.DBytes);
+    }
+}
+
+std::chrono::nanoseconds SConstructionReport::TotalTime() const noexcept{
+    std::chrono::nanoseconds Total{0};
+    for(auto &Phase : DPhases){
+        Total += Phase.DTime;
+    }
+    return Total;
+}
+
+std::size_t SConstructionReport::TotalBytes() const noexcept{
+    std::size_t Total = 0;
+    for(auto &Component : DComponents){
+        Total += Component.DBytes;
+    }
+    return Total;
+}
+
+std::string SConstructionReport::ToString() const{
+    std::stringstream Stream;
+    Stream<<std::fixed<<std::setprecision(3);
+    Stream<<DName<<"\n";
+    for(auto &Phase : DPhases){
+        Stream<<"  phase  "<<std::left<<std::setw(32)<<Phase.DName<<std::right<<std::setw(12)<<Phase.DTime.count() / 1e6<<" ms\n";
+    }
+    if(!DPhases.empty()){
+        Stream<<"  phase  "<<std::left<<std::setw(32)<<"total"<<std::right<<std::setw(12)<<TotalTime().count() / 1e6<<" ms\n";
+    }
+    Stream<<std::setprecision(1);
+    for(auto &Component : DComponents){
+        Stream<<"  memory "<<std::left<<std::setw(32)<<Component.DName<<std::right<<std::setw(12)<<Component.DBytes<<" bytes "
+              <<std::setw(10)<<Component.DCount<<" items";
+        if(Component.DCount){
+            Stream<<std::setw(10)<<double(Component.DBytes) / Component.DCount<<" bytes each";
+        }
+        Stream<<"\n";
+    }
+    Stream<<"  memory "<<std::left<<std::setw(32)<<"total"<<std::right<<std::setw(12)<<TotalBytes()<<" bytes\n";
+    return Stream.str();
+}
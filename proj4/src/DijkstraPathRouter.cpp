@@ -7,50 +7,641 @@
 #include <any>
 #include <memory>
 #include <chrono>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <tuple>
+#include <cmath>
+#include <cstdint>
 
 namespace {
     constexpr double INF = std::numeric_limits<double>::infinity();
+
+    // Queues for FindShortestPath, all expose Push (insert or decrease),
+    // Pop and Empty. Lazy queues may hand out stale entries which the search
+    // skips by comparing against the current distance.
+
+    // Binary heap with lazy deletion, grows with every relaxation
+    template <typename TKey>
+    class BinaryQueue {
+        using Pair = std::pair<TKey, size_t>;
+        std::priority_queue<Pair, std::vector<Pair>, std::greater<Pair>> heap;
+    public:
+        void Reset(size_t) { heap = decltype(heap)(); }
+        bool Empty() const { return heap.empty(); }
+        size_t Size() const { return heap.size(); }
+        void Push(TKey key, size_t vertex) { heap.push({key, vertex}); }
+        Pair Pop() {
+            Pair top = heap.top();
+            heap.pop();
+            return top;
+        }
+    };
+
+    // 4-ary heap indexed by vertex, decrease-key moves an entry in place so
+    // the heap never holds more than one entry per vertex
+    template <typename TKey>
+    class QuaternaryQueue {
+        static constexpr size_t NotQueued = std::numeric_limits<size_t>::max();
+        std::vector<std::pair<TKey, size_t>> heap;
+        std::vector<size_t> position;
+
+        void Place(size_t index, const std::pair<TKey, size_t> &entry) {
+            heap[index] = entry;
+            position[entry.second] = index;
+        }
+
+        void SiftUp(size_t index) {
+            auto entry = heap[index];
+            while (index > 0) {
+                size_t parent = (index - 1) / 4;
+                if (!(entry.first < heap[parent].first))
+                    break;
+                Place(index, heap[parent]);
+                index = parent;
+            }
+            Place(index, entry);
+        }
+
+        void SiftDown(size_t index) {
+            auto entry = heap[index];
+            while (true) {
+                size_t first = index * 4 + 1;
+                if (first >= heap.size())
+                    break;
+                size_t best = first;
+                size_t last = std::min(first + 4, heap.size());
+                for (size_t child = first + 1; child < last; ++child) {
+                    if (heap[child].first < heap[best].first)
+                        best = child;
+                }
+                if (!(heap[best].first < entry.first))
+                    break;
+                Place(index, heap[best]);
+                index = best;
+            }
+            Place(index, entry);
+        }
+
+    public:
+        void Reset(size_t vertexCount) {
+            heap.clear();
+            position.assign(vertexCount, NotQueued);
+        }
+        bool Empty() const { return heap.empty(); }
+        size_t Size() const { return heap.size(); }
+        void Push(TKey key, size_t vertex) {
+            if (position[vertex] == NotQueued) {
+                heap.push_back({key, vertex});
+                position[vertex] = heap.size() - 1;
+                SiftUp(heap.size() - 1);
+            } else if (key < heap[position[vertex]].first) {
+                heap[position[vertex]].first = key;
+                SiftUp(position[vertex]);
+            }
+        }
+        std::pair<TKey, size_t> Pop() {
+            auto top = heap.front();
+            position[top.second] = NotQueued;
+            auto last = heap.back();
+            heap.pop_back();
+            if (!heap.empty()) {
+                Place(0, last);
+                SiftDown(0);
+            }
+            return top;
+        }
+    };
+
+    // Radix heap for monotone integer keys, entries live in buckets by the
+    // highest bit in which they differ from the last key popped so each
+    // entry is moved at most 64 times over a whole search.
+    class RadixQueue {
+        using Pair = std::pair<uint64_t, size_t>;
+        std::vector<Pair> buckets[65];
+        uint64_t lastKey = 0;
+        size_t count = 0;
+
+        static size_t BucketIndex(uint64_t key, uint64_t last) {
+            uint64_t diff = key ^ last;
+            size_t index = 0;
+            while (diff) {
+                ++index;
+                diff >>= 1;
+            }
+            return index;
+        }
+
+    public:
+        void Reset(size_t) {
+            for (auto &bucket : buckets)
+                bucket.clear();
+            lastKey = 0;
+            count = 0;
+        }
+        bool Empty() const { return count == 0; }
+        size_t Size() const { return count; }
+        void Push(uint64_t key, size_t vertex) {
+            buckets[BucketIndex(key, lastKey)].push_back({key, vertex});
+            ++count;
+        }
+        Pair Pop() {
+            if (buckets[0].empty()) {
+                size_t index = 1;
+                while (buckets[index].empty())
+                    ++index;
+                uint64_t minKey = std::numeric_limits<uint64_t>::max();
+                for (const auto &entry : buckets[index])
+                    minKey = std::min(minKey, entry.first);
+                lastKey = minKey;
+                for (const auto &entry : buckets[index])
+                    buckets[BucketIndex(entry.first, lastKey)].push_back(entry);
+                buckets[index].clear();
+            }
+            Pair top = buckets[0].back();
+            buckets[0].pop_back();
+            --count;
+            return top;
+        }
+    };
 }
 
 struct CDijkstraPathRouter::SImplementation {
 
-    // Renamed internal vertex structure to reduce similarity.
+    // Outgoing edges of a vertex, tags are kept apart so the graph itself
+    // is the same whatever the router tags its vertices with. Weights are
+    // parallel to neighbors so a relaxation reads both contiguously, each
+    // neighbor appears once.
     struct VertexData {
-        TVertexID id;
-        std::any tag;
         std::vector<TVertexID> neighbors;
-        std::unordered_map<TVertexID, double> weights;
+        std::vector<double> weights;
 
-        TVertexID fetchID() { 
-            return id; 
+        std::size_t neighborCount() const {
+            return neighbors.size();
         }
 
-        std::any fetchTag() {
-            return tag;
+        double getWeight(const TVertexID &vertex) const {
+            auto it = std::find(neighbors.begin(), neighbors.end(), vertex);
+            return (it == neighbors.end()) ? INF : weights[it - neighbors.begin()];
         }
 
-        std::size_t neighborCount() {
-            return neighbors.size();
+        // Adds an edge or replaces the weight of an existing one
+        void setWeight(TVertexID vertex, double weight) {
+            auto it = std::find(neighbors.begin(), neighbors.end(), vertex);
+            if (it != neighbors.end()) {
+                weights[it - neighbors.begin()] = weight;
+                return;
+            }
+            neighbors.push_back(vertex);
+            weights.push_back(weight);
         }
+    };
+
+    std::vector<VertexData> vertices;
+    // Tags given to AddVertex(std::any), empty when a derived router keeps
+    // its own
+    std::vector<std::any> tags;
+    size_t modificationCounter = 0;
+    EQueueType queueType;
+    double fixedPointScale = 0.0;
+    // Each search counts into its own statistics, which are merged into
+    // these under statisticsMutex so concurrent searches can be measured
+    std::atomic<bool> statisticsEnabled{false};
+    SSearchStatistics lastStatistics;
+    SSearchStatistics totalStatistics;
+    mutable std::mutex statisticsMutex;
+    std::chrono::nanoseconds precomputeTime{0};
+
+    // Contraction hierarchy built by Precompute. Vertices are stored by sweep
+    // position, highest rank first, so the downward sweep of a one-to-all
+    // query walks every array front to back.
+    struct Hierarchy {
+        bool valid = false;
+        size_t generation = 0;
+        std::vector<TVertexID> positionVertex;
+        std::vector<size_t> vertexPosition;
+        // Edges to higher ranked vertices, by position
+        std::vector<size_t> upOffsets;
+        std::vector<size_t> upTargets;
+        std::vector<double> upWeights;
+        // Edges arriving from higher ranked vertices, by position
+        std::vector<size_t> downOffsets;
+        std::vector<size_t> downSources;
+        std::vector<double> downWeights;
+    } hierarchy;
+
+    // Sources handled together by one downward sweep, the per vertex lane
+    // loop is kept branch free so the compiler can vectorize it.
+    static constexpr size_t SweepLanes = 4;
+    // Witness searches give up after this many settled vertices and add the
+    // shortcut, which keeps preprocessing bounded at the cost of a few extra
+    // edges.
+    static constexpr size_t WitnessSettleLimit = 256;
+
+    struct ContractionEdge {
+        TVertexID vertex;
+        double weight;
+    };
+
+    struct ContractionState {
+        std::vector<std::vector<ContractionEdge>> outEdges;
+        std::vector<std::vector<ContractionEdge>> inEdges;
+        std::vector<bool> contracted;
+        std::vector<int> contractedNeighbors;
+        std::vector<double> witnessDist;
+        std::vector<TVertexID> witnessTouched;
+        std::vector<std::tuple<TVertexID, TVertexID, double>> shortcuts;
+    };
 
-        std::vector<TVertexID> getNeighbors() {
-            return neighbors;
+    SImplementation(EQueueType queue) : queueType(queue) {}
+
+    uint64_t FixedPointWeight(double weight) const {
+        return std::max<uint64_t>(1, uint64_t(std::llround(weight * fixedPointScale)));
+    }
+
+    // Lowest offset given for a vertex in a list of seeds
+    static double SeedOffset(const std::vector<std::pair<TVertexID, double>> &seeds, TVertexID vertex) {
+        double offset = INF;
+        for (const auto &seed : seeds) {
+            if (seed.first == vertex)
+                offset = std::min(offset, seed.second);
         }
+        return offset;
+    }
 
-        double getWeight(const TVertexID &vertex) {
-            auto it = weights.find(vertex);
-            return (it == weights.end()) ? INF : it->second;
+    // Search from a set of sources to a set of targets over keys of type
+    // TKey, each seed carries a cost offset converted by keyOf. The search
+    // stops once nothing left in the queue can beat the best target. In
+    // fixed point mode the queue orders vertices by quantized cost but the
+    // returned cost is the exact sum of the offsets and the edge weights
+    // along the path found. Instrumented searches fill stats, the counters
+    // compile away otherwise.
+    template <typename TKey, typename TQueue, bool Instrumented, typename TWeight, typename TOffset>
+    double SearchPath(const std::vector<std::pair<TVertexID, double>> &sources,
+                      const std::vector<std::pair<TVertexID, double>> &targets,
+                      std::vector<TVertexID> &path, SSearchStatistics &stats, TWeight weightOf, TOffset keyOf) {
+        using Clock = std::chrono::steady_clock;
+        Clock::time_point phaseStart;
+        if constexpr (Instrumented) {
+            stats = SSearchStatistics();
+            stats.DSearches = 1;
+            phaseStart = Clock::now();
         }
-    };
+        auto endPhase = [&](std::chrono::nanoseconds &phase) {
+            if constexpr (Instrumented) {
+                auto now = Clock::now();
+                phase = std::chrono::duration_cast<std::chrono::nanoseconds>(now - phaseStart);
+                phaseStart = now;
+            }
+        };
+        auto pushed = [&](const TQueue &queue) {
+            if constexpr (Instrumented) {
+                ++stats.DHeapPushes;
+                stats.DMaxHeapSize = std::max(stats.DMaxHeapSize, queue.Size());
+            }
+        };
+
+        const TKey unreached = std::numeric_limits<TKey>::max();
+        TQueue queue;
+        queue.Reset(vertices.size());
+
+        std::vector<TKey> dist(vertices.size(), unreached);
+        std::vector<TVertexID> prev(vertices.size(), std::numeric_limits<TVertexID>::max());
+
+        // Targets are few, so they are kept sorted by vertex and looked up as
+        // vertices settle rather than marked in another full size array.
+        // The lowest key of a vertex listed twice sorts first.
+        std::vector<std::pair<TVertexID, TKey>> targetKeys;
+        targetKeys.reserve(targets.size());
+        for (const auto &target : targets)
+            targetKeys.push_back({target.first, keyOf(target.second)});
+        std::sort(targetKeys.begin(), targetKeys.end());
+        auto targetKeyOf = [&targetKeys, unreached](TVertexID vertex) {
+            auto search = std::lower_bound(targetKeys.begin(), targetKeys.end(), vertex,
+                [](const std::pair<TVertexID, TKey> &entry, TVertexID id) { return entry.first < id; });
+            return search != targetKeys.end() && search->first == vertex ? search->second : unreached;
+        };
+        for (const auto &source : sources) {
+            TKey key = keyOf(source.second);
+            if (key < dist[source.first]) {
+                dist[source.first] = key;
+                queue.Push(key, source.first);
+                pushed(queue);
+            }
+        }
+        endPhase(stats.DSetupTime);
+
+        TKey best = unreached;
+        TVertexID bestTarget = std::numeric_limits<TVertexID>::max();
+        while (!queue.Empty()) {
+            auto [d, current] = queue.Pop();
+            if constexpr (Instrumented)
+                ++stats.DHeapPops;
+            if (d > dist[current])
+                continue;
+            if (best != unreached && d >= best)
+                break;
+            if constexpr (Instrumented)
+                ++stats.DSettledVertices;
+            TKey targetKey = targetKeyOf(current);
+            if (targetKey != unreached && d + targetKey < best) {
+                best = d + targetKey;
+                bestTarget = current;
+            }
+            const auto &vertex = vertices[current];
+            if constexpr (Instrumented)
+                stats.DRelaxedEdges += vertex.neighbors.size();
+            for (size_t k = 0; k < vertex.neighbors.size(); ++k) {
+                TVertexID nbr = vertex.neighbors[k];
+                TKey alt = dist[current] + weightOf(vertex.weights[k]);
+                if (alt < dist[nbr]) {
+                    dist[nbr] = alt;
+                    prev[nbr] = current;
+                    queue.Push(alt, nbr);
+                    pushed(queue);
+                }
+            }
+        }
+        endPhase(stats.DSearchTime);
+
+        if (best == unreached) {
+            path.clear();
+            return NoPathExists;
+        }
+
+        // Walk back from the target and flip once, prepending each vertex
+        // would be quadratic in the path length
+        path.clear();
+        for (std::size_t i = bestTarget; i != std::numeric_limits<TVertexID>::max(); i = prev[i])
+            path.push_back(i);
+        std::reverse(path.begin(), path.end());
+        double cost = SeedOffset(sources, path.front()) + SeedOffset(targets, path.back());
+        for (size_t i = 1; i < path.size(); ++i)
+            cost += vertices[path[i - 1]].getWeight(path[i]);
+        endPhase(stats.DPathTime);
+        return cost;
+    }
+
+    // Picks the key type, queue and instrumentation once for a search
+    double Search(const std::vector<std::pair<TVertexID, double>> &sources,
+                  const std::vector<std::pair<TVertexID, double>> &targets,
+                  std::vector<TVertexID> &path) {
+        SSearchStatistics stats;
+        if (!statisticsEnabled.load(std::memory_order_relaxed))
+            return SearchWith<false>(sources, targets, path, stats);
+        double cost = SearchWith<true>(sources, targets, path, stats);
+        std::lock_guard<std::mutex> lock(statisticsMutex);
+        lastStatistics = stats;
+        totalStatistics += stats;
+        return cost;
+    }
+
+    template <bool Instrumented>
+    double SearchWith(const std::vector<std::pair<TVertexID, double>> &sources,
+                      const std::vector<std::pair<TVertexID, double>> &targets,
+                      std::vector<TVertexID> &path, SSearchStatistics &stats) {
+        auto doubleWeight = [](double weight) {
+            return weight;
+        };
+        auto doubleOffset = [](double offset) {
+            return offset;
+        };
+        auto fixedWeight = [this](double weight) {
+            return FixedPointWeight(weight);
+        };
+        auto fixedOffset = [this](double offset) {
+            return uint64_t(std::llround(offset * fixedPointScale));
+        };
+        if (fixedPointScale > 0.0) {
+            switch (queueType) {
+                case EQueueType::RadixHeap:
+                    return SearchPath<uint64_t, RadixQueue, Instrumented>(sources, targets, path, stats, fixedWeight, fixedOffset);
+                case EQueueType::QuaternaryHeap:
+                    return SearchPath<uint64_t, QuaternaryQueue<uint64_t>, Instrumented>(sources, targets, path, stats, fixedWeight, fixedOffset);
+                default:
+                    return SearchPath<uint64_t, BinaryQueue<uint64_t>, Instrumented>(sources, targets, path, stats, fixedWeight, fixedOffset);
+            }
+        }
+        // Radix heaps need integer keys, without fixed point weights they fall
+        // back to the binary heap
+        if (queueType == EQueueType::QuaternaryHeap)
+            return SearchPath<double, QuaternaryQueue<double>, Instrumented>(sources, targets, path, stats, doubleWeight, doubleOffset);
+        return SearchPath<double, BinaryQueue<double>, Instrumented>(sources, targets, path, stats, doubleWeight, doubleOffset);
+    }
+
+    bool HierarchyCurrent() const {
+        return hierarchy.valid && hierarchy.generation == modificationCounter;
+    }
+
+    static void WitnessSearch(ContractionState &state, TVertexID src, TVertexID skip, double limit) {
+        using Pair = std::pair<double, TVertexID>;
+        std::priority_queue<Pair, std::vector<Pair>, std::greater<Pair>> queue;
+        state.witnessDist[src] = 0.0;
+        state.witnessTouched.push_back(src);
+        queue.push({0.0, src});
+        size_t settled = 0;
+        while (!queue.empty() && settled < WitnessSettleLimit) {
+            auto [d, current] = queue.top();
+            queue.pop();
+            if (d > state.witnessDist[current])
+                continue;
+            if (d > limit)
+                break;
+            ++settled;
+            for (const auto &edge : state.outEdges[current]) {
+                if (edge.vertex == skip || state.contracted[edge.vertex])
+                    continue;
+                double alt = d + edge.weight;
+                if (alt < state.witnessDist[edge.vertex]) {
+                    if (state.witnessDist[edge.vertex] == INF)
+                        state.witnessTouched.push_back(edge.vertex);
+                    state.witnessDist[edge.vertex] = alt;
+                    queue.push({alt, edge.vertex});
+                }
+            }
+        }
+    }
+
+    // Shortcuts contracting vertex would need, left in state.shortcuts
+    static void FindShortcuts(ContractionState &state, TVertexID vertex) {
+        state.shortcuts.clear();
+        double maxOut = 0.0;
+        for (const auto &out : state.outEdges[vertex])
+            if (!state.contracted[out.vertex])
+                maxOut = std::max(maxOut, out.weight);
+        for (const auto &in : state.inEdges[vertex]) {
+            if (state.contracted[in.vertex])
+                continue;
+            WitnessSearch(state, in.vertex, vertex, in.weight + maxOut);
+            for (const auto &out : state.outEdges[vertex]) {
+                if (state.contracted[out.vertex] || out.vertex == in.vertex)
+                    continue;
+                double via = in.weight + out.weight;
+                if (state.witnessDist[out.vertex] > via)
+                    state.shortcuts.emplace_back(in.vertex, out.vertex, via);
+            }
+            for (auto touched : state.witnessTouched)
+                state.witnessDist[touched] = INF;
+            state.witnessTouched.clear();
+        }
+    }
 
-    std::vector<std::shared_ptr<VertexData>> vertices;
-    size_t vertexCounter = 0;
+    static int ContractionPriority(ContractionState &state, TVertexID vertex) {
+        FindShortcuts(state, vertex);
+        int removed = 0;
+        for (const auto &edge : state.inEdges[vertex])
+            removed += state.contracted[edge.vertex] ? 0 : 1;
+        for (const auto &edge : state.outEdges[vertex])
+            removed += state.contracted[edge.vertex] ? 0 : 1;
+        return int(state.shortcuts.size()) - removed + state.contractedNeighbors[vertex];
+    }
+
+    static void AddContractionEdge(std::vector<ContractionEdge> &edges, TVertexID vertex, double weight) {
+        for (auto &edge : edges) {
+            if (edge.vertex == vertex) {
+                edge.weight = std::min(edge.weight, weight);
+                return;
+            }
+        }
+        edges.push_back({vertex, weight});
+    }
+
+    bool BuildHierarchy(std::chrono::steady_clock::time_point deadline) {
+        size_t n = vertices.size();
+        ContractionState state;
+        state.outEdges.resize(n);
+        state.inEdges.resize(n);
+        state.contracted.assign(n, false);
+        state.contractedNeighbors.assign(n, 0);
+        state.witnessDist.assign(n, INF);
+        for (TVertexID v = 0; v < n; ++v) {
+            for (size_t k = 0; k < vertices[v].neighbors.size(); ++k) {
+                TVertexID target = vertices[v].neighbors[k];
+                double weight = vertices[v].weights[k];
+                if (target == v)
+                    continue;
+                state.outEdges[v].push_back({target, weight});
+                state.inEdges[target].push_back({v, weight});
+            }
+        }
+
+        // Lazy updates: a popped vertex is re-queued if its priority got
+        // worse than the next candidate since it was pushed.
+        using Pair = std::pair<int, TVertexID>;
+        std::priority_queue<Pair, std::vector<Pair>, std::greater<Pair>> queue;
+        for (TVertexID v = 0; v < n; ++v) {
+            // Each priority runs witness searches, so a short budget can run
+            // out before contraction starts
+            if ((v & 63) == 0 && std::chrono::steady_clock::now() > deadline)
+                return false;
+            queue.push({ContractionPriority(state, v), v});
+        }
+        std::vector<size_t> rank(n, 0);
+        size_t nextRank = 0;
+        while (!queue.empty()) {
+            if ((nextRank & 63) == 0 && std::chrono::steady_clock::now() > deadline)
+                return false;
+            TVertexID vertex = queue.top().second;
+            queue.pop();
+            if (state.contracted[vertex])
+                continue;
+            int priority = ContractionPriority(state, vertex);
+            if (!queue.empty() && priority > queue.top().first) {
+                queue.push({priority, vertex});
+                continue;
+            }
+            for (const auto &[from, to, weight] : state.shortcuts) {
+                AddContractionEdge(state.outEdges[from], to, weight);
+                AddContractionEdge(state.inEdges[to], from, weight);
+            }
+            state.contracted[vertex] = true;
+            rank[vertex] = nextRank++;
+            for (const auto &edge : state.inEdges[vertex])
+                state.contractedNeighbors[edge.vertex]++;
+            for (const auto &edge : state.outEdges[vertex])
+                state.contractedNeighbors[edge.vertex]++;
+        }
+
+        Hierarchy result;
+        result.positionVertex.resize(n);
+        result.vertexPosition.resize(n);
+        for (TVertexID v = 0; v < n; ++v) {
+            result.vertexPosition[v] = n - 1 - rank[v];
+            result.positionVertex[n - 1 - rank[v]] = v;
+        }
+        result.upOffsets.push_back(0);
+        result.downOffsets.push_back(0);
+        for (size_t position = 0; position < n; ++position) {
+            TVertexID v = result.positionVertex[position];
+            for (const auto &edge : state.outEdges[v]) {
+                if (rank[edge.vertex] > rank[v]) {
+                    result.upTargets.push_back(result.vertexPosition[edge.vertex]);
+                    result.upWeights.push_back(edge.weight);
+                }
+            }
+            for (const auto &edge : state.inEdges[v]) {
+                if (rank[edge.vertex] > rank[v]) {
+                    result.downSources.push_back(result.vertexPosition[edge.vertex]);
+                    result.downWeights.push_back(edge.weight);
+                }
+            }
+            result.upOffsets.push_back(result.upTargets.size());
+            result.downOffsets.push_back(result.downSources.size());
+        }
+        result.valid = true;
+        result.generation = modificationCounter;
+        hierarchy = std::move(result);
+        return true;
+    }
 
-    SImplementation() {}
+    // Full trees for up to SweepLanes sources: an upward search per source
+    // followed by one downward sweep over all vertices in rank order.
+    void SweepBatch(const TVertexID *sources, size_t count, std::vector<double> &lanes, std::vector<double> **dist) const {
+        size_t n = hierarchy.positionVertex.size();
+        lanes.assign(n * SweepLanes, INF);
+        using Pair = std::pair<double, size_t>;
+        for (size_t lane = 0; lane < count; ++lane) {
+            std::priority_queue<Pair, std::vector<Pair>, std::greater<Pair>> queue;
+            size_t start = hierarchy.vertexPosition[sources[lane]];
+            lanes[start * SweepLanes + lane] = 0.0;
+            queue.push({0.0, start});
+            while (!queue.empty()) {
+                auto [d, current] = queue.top();
+                queue.pop();
+                if (d > lanes[current * SweepLanes + lane])
+                    continue;
+                for (size_t e = hierarchy.upOffsets[current]; e < hierarchy.upOffsets[current + 1]; ++e) {
+                    double alt = d + hierarchy.upWeights[e];
+                    double &target = lanes[hierarchy.upTargets[e] * SweepLanes + lane];
+                    if (alt < target) {
+                        target = alt;
+                        queue.push({alt, hierarchy.upTargets[e]});
+                    }
+                }
+            }
+        }
+        for (size_t position = 0; position < n; ++position) {
+            double *target = &lanes[position * SweepLanes];
+            for (size_t e = hierarchy.downOffsets[position]; e < hierarchy.downOffsets[position + 1]; ++e) {
+                const double *from = &lanes[hierarchy.downSources[e] * SweepLanes];
+                double weight = hierarchy.downWeights[e];
+                for (size_t lane = 0; lane < SweepLanes; ++lane)
+                    target[lane] = std::min(target[lane], from[lane] + weight);
+            }
+        }
+        for (size_t lane = 0; lane < count; ++lane) {
+            auto &out = *dist[lane];
+            out.resize(n);
+            for (size_t position = 0; position < n; ++position) {
+                double d = lanes[position * SweepLanes + lane];
+                out[hierarchy.positionVertex[position]] = d == INF ? NoPathExists : d;
+            }
+        }
+    }
 };
 
-CDijkstraPathRouter::CDijkstraPathRouter() {
-    DImplementation = std::make_unique<SImplementation>();
+CDijkstraPathRouter::CDijkstraPathRouter(EQueueType queue) {
+    DImplementation = std::make_unique<SImplementation>(queue);
 }
 
 CDijkstraPathRouter::~CDijkstraPathRouter() {}
@@ -60,88 +651,214 @@ std::size_t CDijkstraPathRouter::VertexCount() const noexcept {
 }
 
 CPathRouter::TVertexID CDijkstraPathRouter::AddVertex(std::any tag) noexcept {
-    auto tempVertex = std::make_shared<SImplementation::VertexData>();
-    tempVertex->id = DImplementation->vertexCounter;
-    tempVertex->tag = tag;
-    DImplementation->vertices.push_back(tempVertex);
-    return DImplementation->vertexCounter++;
+    auto &tags = DImplementation->tags;
+    // Pads with empty tags if vertices were added without one
+    tags.resize(DImplementation->vertices.size());
+    tags.push_back(std::move(tag));
+    return AddUntaggedVertex();
 }
 
 std::any CDijkstraPathRouter::GetVertexTag(TVertexID id) const noexcept {
-    return DImplementation->vertices.at(id)->fetchTag();
+    const auto &tags = DImplementation->tags;
+    return id < tags.size() ? tags[id] : std::any();
+}
+
+CPathRouter::TVertexID CDijkstraPathRouter::AddUntaggedVertex() noexcept {
+    DImplementation->vertices.emplace_back();
+    DImplementation->modificationCounter++;
+    return DImplementation->vertices.size() - 1;
+}
+
+void CDijkstraPathRouter::ReserveVertices(std::size_t count) {
+    DImplementation->vertices.reserve(count);
 }
 
 bool CDijkstraPathRouter::AddEdge(TVertexID src, TVertexID dest, double weight, bool bidir) noexcept {
-    if (weight <= 0) 
+    auto &vertices = DImplementation->vertices;
+    if (weight <= 0 || src >= vertices.size() || dest >= vertices.size())
         return false;
 
-    auto sourceVertex = DImplementation->vertices.at(src);
-    sourceVertex->weights[dest] = weight;
-    sourceVertex->neighbors.push_back(dest);
+    vertices[src].setWeight(dest, weight);
+    if(bidir)
+        vertices[dest].setWeight(src, weight);
+    DImplementation->modificationCounter++;
+    return true;
+}
 
-    if(bidir) {
-        auto destVertex = DImplementation->vertices.at(dest);
-        destVertex->weights[src] = weight;
-        destVertex->neighbors.push_back(src);
-    }
+CDijkstraPathRouter::EQueueType CDijkstraPathRouter::QueueType() const noexcept {
+    return DImplementation->queueType;
+}
+
+void CDijkstraPathRouter::SetQueueType(EQueueType queue) noexcept {
+    DImplementation->queueType = queue;
+}
+
+double CDijkstraPathRouter::FixedPointScale() const noexcept {
+    return DImplementation->fixedPointScale;
+}
+
+bool CDijkstraPathRouter::SetFixedPointScale(double scale) noexcept {
+    if (scale < 0.0 || !std::isfinite(scale))
+        return false;
+    DImplementation->fixedPointScale = scale;
     return true;
 }
 
+std::size_t CDijkstraPathRouter::ModificationCount() const noexcept {
+    return DImplementation->modificationCounter;
+}
+
 bool CDijkstraPathRouter::Precompute(std::chrono::steady_clock::time_point deadline) noexcept {
-    // Placeholder
+    // Builds the contraction hierarchy used by FindShortestPathTrees, a
+    // hierarchy that misses the deadline is discarded and plain searches are
+    // used instead.
+    auto start = std::chrono::steady_clock::now();
+    DImplementation->hierarchy = SImplementation::Hierarchy();
+    bool built = DImplementation->BuildHierarchy(deadline);
+    DImplementation->precomputeTime = std::chrono::steady_clock::now() - start;
+    return built;
+}
+
+bool CDijkstraPathRouter::HasHierarchy() const noexcept {
+    return DImplementation->HierarchyCurrent();
+}
+
+void CDijkstraPathRouter::SetSearchStatisticsEnabled(bool enable) noexcept {
+    DImplementation->statisticsEnabled.store(enable, std::memory_order_relaxed);
+}
+
+bool CDijkstraPathRouter::SearchStatisticsEnabled() const noexcept {
+    return DImplementation->statisticsEnabled.load(std::memory_order_relaxed);
+}
+
+CDijkstraPathRouter::SSearchStatistics CDijkstraPathRouter::LastSearchStatistics() const noexcept {
+    std::lock_guard<std::mutex> lock(DImplementation->statisticsMutex);
+    return DImplementation->lastStatistics;
+}
+
+CDijkstraPathRouter::SSearchStatistics CDijkstraPathRouter::SearchStatistics() const noexcept {
+    std::lock_guard<std::mutex> lock(DImplementation->statisticsMutex);
+    return DImplementation->totalStatistics;
+}
+
+bool CDijkstraPathRouter::ConstructionReport(SConstructionReport &report) const noexcept {
+    const auto &impl = *DImplementation;
+    report = SConstructionReport();
+    report.DName = "CDijkstraPathRouter";
+    report.AddPhase("precompute", impl.precomputeTime);
+    size_t edges = 0;
+    size_t edgeBytes = 0;
+    for (const auto &vertex : impl.vertices) {
+        edges += vertex.neighbors.size();
+        edgeBytes += SConstructionReport::VectorBytes(vertex.neighbors) + SConstructionReport::VectorBytes(vertex.weights);
+    }
+    report.AddComponent("vertices", impl.vertices.size(), SConstructionReport::VectorBytes(impl.vertices));
+    if (!impl.tags.empty())
+        report.AddComponent("vertex tags", impl.tags.size(), SConstructionReport::VectorBytes(impl.tags));
+    report.AddComponent("edges", edges, edgeBytes);
+    const auto &hierarchy = impl.hierarchy;
+    report.AddComponent("hierarchy edges", hierarchy.upTargets.size() + hierarchy.downSources.size(),
+                        SConstructionReport::VectorBytes(hierarchy.positionVertex) + SConstructionReport::VectorBytes(hierarchy.vertexPosition) +
+                        SConstructionReport::VectorBytes(hierarchy.upOffsets) + SConstructionReport::VectorBytes(hierarchy.upTargets) +
+                        SConstructionReport::VectorBytes(hierarchy.upWeights) + SConstructionReport::VectorBytes(hierarchy.downOffsets) +
+                        SConstructionReport::VectorBytes(hierarchy.downSources) + SConstructionReport::VectorBytes(hierarchy.downWeights));
     return true;
 }
 
+void CDijkstraPathRouter::ResetSearchStatistics() noexcept {
+    std::lock_guard<std::mutex> lock(DImplementation->statisticsMutex);
+    DImplementation->lastStatistics = SSearchStatistics();
+    DImplementation->totalStatistics = SSearchStatistics();
+}
+
 double CDijkstraPathRouter::FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path) noexcept {
     path.clear();
 
-    if (DImplementation->vertices.size() < src || DImplementation->vertices.size() < dest) {
+    if (DImplementation->vertices.size() <= src || DImplementation->vertices.size() <= dest) {
         return NoPathExists;
     }
+    return DImplementation->Search({{src, 0.0}}, {{dest, 0.0}}, path);
+}
+
+double CDijkstraPathRouter::FindShortestPathBetweenSets(const std::vector<std::pair<TVertexID, double>> &sources,
+                                                        const std::vector<std::pair<TVertexID, double>> &targets,
+                                                        std::vector<TVertexID> &path) noexcept {
+    path.clear();
+    auto validSeed = [this](const std::pair<TVertexID, double> &seed) {
+        return seed.first < DImplementation->vertices.size() && seed.second >= 0.0 && seed.second < INF;
+    };
+    if (sources.empty() || targets.empty() || !std::all_of(sources.begin(), sources.end(), validSeed) ||
+        !std::all_of(targets.begin(), targets.end(), validSeed))
+        return NoPathExists;
+    return DImplementation->Search(sources, targets, path);
+}
+
+bool CDijkstraPathRouter::FindShortestPathTree(TVertexID src, std::vector<double> &dist, std::vector<TVertexID> &prev, double maxcost) noexcept {
+    const auto &vertices = DImplementation->vertices;
+    dist.assign(vertices.size(), NoPathExists);
+    prev.assign(vertices.size(), InvalidVertexID);
+    if (src >= vertices.size())
+        return false;
 
     using Pair = std::pair<double, TVertexID>;
     std::priority_queue<Pair, std::vector<Pair>, std::greater<Pair>> queue;
-
-    std::vector<double> dist(DImplementation->vertices.size(), INF);
-    std::vector<TVertexID> prev(DImplementation->vertices.size(), std::numeric_limits<TVertexID>::max());
+    std::vector<bool> settled(vertices.size(), false);
 
     dist[src] = 0.0;
     queue.push({0.0, src});
-
-    bool found = false;
-    while (!queue.empty() && !found) {
+    while (!queue.empty()) {
         auto [d, current] = queue.top();
         queue.pop();
-
-        if (d <= dist[current]) {
-            if (current == dest) {
-                found = true;
-            } else {
-                const auto neighborsList = DImplementation->vertices[current]->getNeighbors();
-                for (const auto &nbr : neighborsList) {
-                    double alt = dist[current] + DImplementation->vertices[current]->getWeight(nbr);
-                    if (alt < dist[nbr]) {
-                        dist[nbr] = alt;
-                        prev[nbr] = current;
-                        queue.push({alt, nbr});
-                    }
-                }
+        // Everything left in the queue costs at least d, so the sweep is done
+        if (d > maxcost)
+            break;
+        if (settled[current])
+            continue;
+        settled[current] = true;
+        const auto &vertex = vertices[current];
+        for (size_t k = 0; k < vertex.neighbors.size(); ++k) {
+            TVertexID nbr = vertex.neighbors[k];
+            double alt = d + vertex.weights[k];
+            if (alt <= maxcost && alt < dist[nbr]) {
+                dist[nbr] = alt;
+                prev[nbr] = current;
+                queue.push({alt, nbr});
             }
         }
     }
+    return true;
+}
 
-    if (!found || dist[dest] == INF) {
-        path.clear();
-        return NoPathExists;
+bool CDijkstraPathRouter::FindShortestPathTrees(const std::vector<TVertexID> &sources, std::vector<std::vector<double>> &dist) noexcept {
+    dist.assign(sources.size(), std::vector<double>());
+    for (auto source : sources) {
+        if (source >= DImplementation->vertices.size())
+            return false;
     }
+    if (!DImplementation->HierarchyCurrent())
+        return CPathRouter::FindShortestPathTrees(sources, dist);
 
-    for (std::size_t i = dest; i != src; i = prev[i]) {
-        if (prev[i] == std::numeric_limits<TVertexID>::max()) {
-            path.clear();
-            return NoPathExists;
+    // Batches of SweepLanes sources are handed out to the workers in order
+    const size_t lanes = SImplementation::SweepLanes;
+    size_t batchCount = (sources.size() + lanes - 1) / lanes;
+    size_t workerCount = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), batchCount);
+    std::atomic<size_t> nextBatch(0);
+    auto worker = [&]() {
+        std::vector<double> laneDist;
+        std::vector<double> *outputs[lanes];
+        for (size_t batch = nextBatch++; batch < batchCount; batch = nextBatch++) {
+            size_t first = batch * lanes;
+            size_t count = std::min(lanes, sources.size() - first);
+            for (size_t lane = 0; lane < count; ++lane)
+                outputs[lane] = &dist[first + lane];
+            DImplementation->SweepBatch(&sources[first], count, laneDist, outputs);
         }
-        path.insert(path.begin(), i); // Prepend i to the path
-    }
-    path.insert(path.begin(), src);
-    return dist[dest];
+    };
+    std::vector<std::thread> threads;
+    for (size_t index = 1; index < workerCount; ++index)
+        threads.emplace_back(worker);
+    worker();
+    for (auto &thread : threads)
+        thread.join();
+    return true;
 }
@@ -1,6 +1,7 @@
 #include "DijkstraTransportationPlanner.h"
 #include "DijkstraPathRouter.h"
 #include "GeographicUtils.h"
+#include "RoutingProfile.h"
 #include <queue>
 #include <unordered_map>
 #include <set>
@@ -9,58 +10,246 @@
 #include <sstream>
 #include <iomanip>
 #include <limits>
+#include <iterator>
+#include <cstdio>
+#include <array>
+#include <chrono>
+#include <mutex>
+
+// Distances follow oneway streets like driving but cost miles
+struct SDistanceProfile {
+    static bool Allows(const SRoutingWay &way, bool reverse) noexcept {
+        return !(reverse && way.Has(SRoutingWay::Oneway));
+    }
+    static double Speed(const SRoutingWay &way, const SRoutingSpeeds &speeds) noexcept {
+        return 1.0;
+    }
+};
 
 struct CDijkstraTransportationPlanner::SImplementation {
     std::shared_ptr<SConfiguration> configPtr;
-    std::vector<std::shared_ptr<CStreetMap::SNode>> orderedNodes;
-    std::shared_ptr<CDijkstraPathRouter> distRouter;
-    std::shared_ptr<CDijkstraPathRouter> timeRouter;
-    std::unordered_map<CStreetMap::TNodeID, CPathRouter::TVertexID> nodeToDistVertex;
-    std::unordered_map<CStreetMap::TNodeID, CPathRouter::TVertexID> nodeToTimeVertex;
-    std::unordered_map<CPathRouter::TVertexID, CStreetMap::TNodeID> distVertexToNode;
-    std::unordered_map<CPathRouter::TVertexID, CStreetMap::TNodeID> timeVertexToNode;
-    std::unordered_map<CStreetMap::TNodeID, size_t> nodeIndexMap;
+    // Nodes sorted by ID. The street map is held by configPtr for the life
+    // of the planner, so plain pointers are safe and keep reference counting
+    // out of the loops over them.
+    std::vector<const CStreetMap::SNode *> orderedNodes;
+    // Street map index of each sorted node, for SortedNodeByIndex
+    std::vector<size_t> orderedNodeSources;
+    // IDs of the sorted nodes, the one lookup from node ID to sorted index
+    // is a binary search over these
+    std::vector<CStreetMap::TNodeID> orderedNodeIDs;
+    static constexpr size_t InvalidIndex = std::numeric_limits<size_t>::max();
+    // Vertices are tagged with their node IDs. All three routers add their
+    // vertices in the same order, so one pair of arrays translates between
+    // sorted node indices and the vertices of any of them.
+    using TRouter = CDijkstraPathRouterT<CStreetMap::TNodeID>;
+    std::shared_ptr<TRouter> distRouter;
+    std::shared_ptr<TRouter> timeRouter;
+    std::shared_ptr<TRouter> bikeRouter;
+    std::vector<CPathRouter::TVertexID> indexVertex;
+    std::vector<size_t> vertexIndex;
     std::unordered_map<CBusSystem::TStopID, CStreetMap::TNodeID> stopToNodeMap;
     std::unordered_map<CBusSystem::TStopID, std::string> stopNames;
     std::unordered_map<CStreetMap::TNodeID, CBusSystem::TStopID> nodeToStop;
     std::unordered_map<CStreetMap::TNodeID, std::set<std::pair<std::string, CStreetMap::TNodeID>>> busRoutes;
+    std::shared_ptr<CBusPathStore> busPaths;
+    std::unique_ptr<CPathCache> pathCache;
+    std::unique_ptr<CSpatialIndex> spatialIndex;
+    // One entry per street segment, holding the street edge it was built
+    // from, for snapping locations onto roads
+    std::unique_ptr<CSegmentIndex> segmentIndex;
+    std::vector<size_t> segmentEdges;
+    // Constructor phase times, memory is measured when a report is asked for
+    SConstructionReport buildReport;
+
+    // Street edges in compressed sparse row form indexed by sorted node
+    // index, recorded in both directions for every way they lie on with the
+    // index of that way, their length, whether they run against the way's
+    // node order and their bearing so a path can be described or routed per
+    // profile without going back to the street map.
+    struct SPendingStreetEdge {
+        size_t src;
+        size_t dest;
+        uint32_t way;
+        double length;
+        bool reverse;
+    };
+    std::vector<size_t> streetEdgeOffsets;
+    std::vector<size_t> streetEdgeTargets;
+    std::vector<uint32_t> streetEdgeWays;
+    std::vector<double> streetEdgeLengths;
+    std::vector<uint8_t> streetEdgeReverse;
+    // Bearings in hundredths of a degree, half the size of a float and still
+    // far finer than the eight compass points paths are described with
+    std::vector<int16_t> streetEdgeBearings;
+    std::vector<SPendingStreetEdge> pendingStreetEdges;
+
+    // Ways that contribute street edges with the attributes paths are
+    // annotated with, interned in wayStrings where index 0 is "".
+    std::vector<CStreetMap::TWayID> wayIDs;
+    std::vector<uint32_t> wayNames;
+    std::vector<uint32_t> wayMaxSpeeds;
+    std::vector<uint32_t> wayHighways;
+    std::vector<std::string> wayStrings;
+    std::unordered_map<std::string, uint32_t> wayStringLookup;
+    std::vector<SRoutingWay> wayRouting;
+    std::vector<CStreetMap::TLocation> wayLocations;
+    // Sorted index of each node of the way last measured, InvalidIndex for
+    // nodes missing from the map
+    std::vector<size_t> wayNodeIndices;
+    std::mutex hierarchyMutex;
+    bool hierarchyAttempted = false;
+    SRoutingSpeeds routingSpeeds;
+
+    // Read only view of the street edges for the profile search kernel
+    struct SStreetGraph {
+        const SImplementation &impl;
+
+        size_t VertexCount() const { return impl.orderedNodes.size(); }
+        size_t EdgeBegin(size_t vertex) const { return impl.streetEdgeOffsets[vertex]; }
+        size_t EdgeEnd(size_t vertex) const { return impl.streetEdgeOffsets[vertex + 1]; }
+        size_t Target(size_t edge) const { return impl.streetEdgeTargets[edge]; }
+        double Length(size_t edge) const { return impl.streetEdgeLengths[edge]; }
+        const SRoutingWay &Way(size_t edge) const { return impl.wayRouting[impl.streetEdgeWays[edge]]; }
+        bool Reverse(size_t edge) const { return impl.streetEdgeReverse[edge]; }
+    };
+
+    // Travel time graph over sorted node indices with one edge per (src,
+    // dest) pair. While it is built each edge holds the cost in hours of
+    // each way to traverse it, INF where that mode cannot use the edge, and
+    // the routers are derived from it per profile: bikeRouter rides the bike
+    // lane, timeRouter walks or takes the bus. The routers hold the weights
+    // from then on, the graph only keeps which edges are bus legs so transit
+    // paths can be told apart from walks.
+    enum ETimeLane : size_t {WalkLane, BikeLane, BusLane, LaneCount};
+    using TLaneCosts = std::array<double, LaneCount>;
+    struct SPendingTimeEdge {
+        size_t src;
+        size_t dest;
+        ETimeLane lane;
+        double cost;
+    };
+    std::vector<size_t> timeEdgeOffsets;
+    std::vector<size_t> timeEdgeTargets;
+    std::vector<bool> timeEdgeBus;
+    std::vector<SPendingTimeEdge> pendingTimeEdges;
+
+    // Sums travel time over consecutive stretches of equal mode and speed,
+    // dividing each stretch's total distance once so a trip's time does not
+    // depend on how finely its road is split into segments.
+    struct STravelTime {
+        double time = 0.0;
+        ETimeLane lane = WalkLane;
+        double speed = 0.0;
+        double distance = 0.0;
+        size_t stops = 0;
+        double stopTime;
+
+        explicit STravelTime(double busStopTime) : stopTime(busStopTime) {}
+
+        void Add(ETimeLane segmentLane, double segmentSpeed, double segmentDistance) {
+            if (segmentLane != lane || segmentSpeed != speed)
+                Flush();
+            lane = segmentLane;
+            speed = segmentSpeed;
+            distance += segmentDistance;
+        }
+
+        void AddStop() {
+            stops++;
+        }
+
+        void Flush() {
+            if (speed > 0.0)
+                time += distance / speed + (stops * stopTime) / 3600.0;
+            distance = 0.0;
+            stops = 0;
+        }
+
+        double Total() {
+            Flush();
+            return time;
+        }
+    };
     
     SImplementation(std::shared_ptr<SConfiguration> cfg)
-        : configPtr(cfg) {
+        : configPtr(cfg),
+          routingSpeeds{cfg->WalkSpeed(), cfg->BikeSpeed(), cfg->DefaultSpeedLimit()} {
+        SConstructionReport::CPhaseTimer timer(buildReport);
         auto streetMap = configPtr->StreetMap();
         auto busSystem = configPtr->BusSystem();
+        busPaths = configPtr->BusPaths();
+        InternWayString("");    // index 0 is reserved for missing attributes
+        if (configPtr->PathCacheSize() > 0)
+            pathCache = std::make_unique<CPathCache>(configPtr->PathCacheSize());
         
         // Create path routers.
-        distRouter = std::make_shared<CDijkstraPathRouter>();
-        timeRouter = std::make_shared<CDijkstraPathRouter>();
+        distRouter = std::make_shared<TRouter>();
+        timeRouter = std::make_shared<TRouter>();
+        bikeRouter = std::make_shared<TRouter>();
+        // Integer distances allow the monotone radix queue
+        if (distRouter->SetFixedPointScale(configPtr->DistanceFixedPointScale()) && configPtr->DistanceFixedPointScale() > 0.0)
+            distRouter->SetQueueType(CDijkstraPathRouter::EQueueType::RadixHeap);
         
         // Build and sort nodes.
+        std::vector<std::pair<const CStreetMap::SNode *, size_t>> mapNodes;
+        mapNodes.reserve(streetMap->NodeCount());
         for (size_t i = 0; i < streetMap->NodeCount(); ++i) {
-            auto node = streetMap->NodeByIndex(i);
-            orderedNodes.push_back(node);
+            if (auto node = streetMap->NodePtrByIndex(i))
+                mapNodes.push_back({node, i});
         }
-        std::sort(orderedNodes.begin(), orderedNodes.end(),
+        std::sort(mapNodes.begin(), mapNodes.end(),
             [](const auto &a, const auto &b) {
-                return a->ID() < b->ID();
+                return a.first->ID() < b.first->ID();
             });
-        for (size_t i = 0; i < orderedNodes.size(); ++i) {
-            nodeIndexMap[orderedNodes[i]->ID()] = i;
+        orderedNodes.reserve(mapNodes.size());
+        orderedNodeSources.reserve(mapNodes.size());
+        orderedNodeIDs.reserve(mapNodes.size());
+        for (const auto &entry : mapNodes) {
+            orderedNodes.push_back(entry.first);
+            orderedNodeSources.push_back(entry.second);
+            orderedNodeIDs.push_back(entry.first->ID());
         }
+        timer.Lap("sort nodes");
         
-        // Build vertex mappings and add vertices to both routers.
-        for (size_t i = 0; i < orderedNodes.size(); ++i) {
-            auto node = orderedNodes[i];
-            auto dVert = distRouter->AddVertex(node->ID());
-            auto tVert = timeRouter->AddVertex(node->ID());
-            nodeToDistVertex[node->ID()] = dVert;
-            nodeToTimeVertex[node->ID()] = tVert;
-            distVertexToNode[dVert] = node->ID();
-            timeVertexToNode[tVert] = node->ID();
+        // Build vertex mappings and add vertices to both routers, in the
+        // configured order. Node IDs are only ever exposed through the
+        // mappings so the numbering stays internal.
+        std::vector<size_t> vertexOrder(orderedNodes.size());
+        for (size_t i = 0; i < vertexOrder.size(); ++i)
+            vertexOrder[i] = i;
+        if (configPtr->VertexOrder() == EVertexOrder::Hilbert && !orderedNodes.empty()) {
+            auto lower = orderedNodes.front()->Location();
+            auto upper = lower;
+            for (const auto &node : orderedNodes) {
+                auto loc = node->Location();
+                lower = {std::min(lower.first, loc.first), std::min(lower.second, loc.second)};
+                upper = {std::max(upper.first, loc.first), std::max(upper.second, loc.second)};
+            }
+            std::vector<uint64_t> keys(orderedNodes.size());
+            for (size_t i = 0; i < keys.size(); ++i)
+                keys[i] = SGeographicUtils::HilbertIndex(orderedNodes[i]->Location(), lower, upper);
+            std::stable_sort(vertexOrder.begin(), vertexOrder.end(),
+                [&keys](size_t a, size_t b) {
+                    return keys[a] < keys[b];
+                });
+        }
+        distRouter->ReserveVertices(vertexOrder.size());
+        timeRouter->ReserveVertices(vertexOrder.size());
+        bikeRouter->ReserveVertices(vertexOrder.size());
+        indexVertex.resize(vertexOrder.size());
+        vertexIndex.reserve(vertexOrder.size());
+        for (size_t index : vertexOrder) {
+            auto nodeID = orderedNodeIDs[index];
+            indexVertex[index] = distRouter->AddVertex(nodeID);
+            timeRouter->AddVertex(nodeID);
+            bikeRouter->AddVertex(nodeID);
+            vertexIndex.push_back(index);
         }
+        timer.Lap("router vertices");
         
         // Map bus stops to nodes.
         for (size_t i = 0; i < busSystem->StopCount(); ++i) {
-            auto stop = busSystem->StopByIndex(i);
+            auto stop = busSystem->StopPtrByIndex(i);
             stopToNodeMap[stop->ID()] = stop->NodeID();
             auto nodeID = stop->NodeID();
             if (nodeToStop.find(nodeID) == nodeToStop.end() || stop->ID() < nodeToStop[nodeID])
@@ -69,13 +258,13 @@ struct CDijkstraTransportationPlanner::SImplementation {
         
         // Build bus route information.
         for (size_t r = 0; r < busSystem->RouteCount(); ++r) {
-            auto route = busSystem->RouteByIndex(r);
+            auto route = busSystem->RoutePtrByIndex(r);
             std::string routeName = route->Name();
             for (size_t i = 0; i < route->StopCount() - 1; ++i) {
                 auto currStopID = route->GetStopID(i);
                 auto nextStopID = route->GetStopID(i + 1);
-                auto currStop = busSystem->StopByID(currStopID);
-                auto nextStop = busSystem->StopByID(nextStopID);
+                auto currStop = busSystem->StopPtrByID(currStopID);
+                auto nextStop = busSystem->StopPtrByID(nextStopID);
                 if (currStop && nextStop) {
                     auto currNodeID = currStop->NodeID();
                     auto nextNodeID = nextStop->NodeID();
@@ -83,132 +272,443 @@ struct CDijkstraTransportationPlanner::SImplementation {
                 }
             }
         }
+        timer.Lap("bus stops and routes");
         
         // Process multi-node ways (node count > 2).
+        std::vector<double> segmentLengths;
         for (size_t i = 0; i < streetMap->WayCount(); ++i) {
-            auto way = streetMap->WayByIndex(i);
+            auto way = streetMap->WayPtrByIndex(i);
             if (way->NodeCount() <= 2)
                 continue;
-            bool isOneway = false;
-            if (way->HasAttribute("oneway")) {
-                std::string val = way->GetAttribute("oneway");
-                isOneway = (val == "yes" || val == "true" || val == "1");
-            }
+            uint32_t wayIndex = AddWayRecord(*way);
+            bool isOneway = wayRouting[wayIndex].Has(SRoutingWay::Oneway);
+            WaySegmentLengths(*way, segmentLengths);
             for (size_t j = 1; j < way->NodeCount(); ++j) {
-                auto srcID = way->GetNodeID(j - 1);
-                auto destID = way->GetNodeID(j);
-                if (srcID == CStreetMap::InvalidNodeID || destID == CStreetMap::InvalidNodeID)
-                    continue;
-                auto srcNode = streetMap->NodeByID(srcID);
-                auto destNode = streetMap->NodeByID(destID);
-                if (!srcNode || !destNode) {
-                    continue;
-                }
-                double dist = SGeographicUtils::HaversineDistanceInMiles(srcNode->Location(), destNode->Location());
+                auto srcIndex = wayNodeIndices[j - 1];
+                auto destIndex = wayNodeIndices[j];
+                double dist = segmentLengths[j - 1];
                 if (dist <= 0.0) {
                     continue;
                 }
-                auto srcDVert = nodeToDistVertex[srcID];
-                auto destDVert = nodeToDistVertex[destID];
-                distRouter->AddEdge(srcDVert, destDVert, dist, false);
+                AddStreetEdges(srcIndex, destIndex, wayIndex, dist);
+                distRouter->AddEdge(indexVertex[srcIndex], indexVertex[destIndex], dist, false);
                 if (!isOneway)
-                    distRouter->AddEdge(destDVert, srcDVert, dist, false);
+                    distRouter->AddEdge(indexVertex[destIndex], indexVertex[srcIndex], dist, false);
                 
-                auto srcTVert = nodeToTimeVertex[srcID];
-                auto destTVert = nodeToTimeVertex[destID];
-                double walkTime = dist / configPtr->WalkSpeed();
-                timeRouter->AddEdge(srcTVert, destTVert, walkTime, false);
-                timeRouter->AddEdge(destTVert, srcTVert, walkTime, false);
-                double bikeTime = dist / configPtr->BikeSpeed();
-                timeRouter->AddEdge(srcTVert, destTVert, bikeTime, false);
-                if (!isOneway)
-                    timeRouter->AddEdge(destTVert, srcTVert, bikeTime, false);
-                double speedLimit = configPtr->DefaultSpeedLimit();
-                if (way->HasAttribute("maxspeed")) {
-                    try {
-                        std::string spd = way->GetAttribute("maxspeed");
-                        size_t pos = spd.find(' ');
-                        if (pos != std::string::npos)
-                            spd = spd.substr(0, pos);
-                        speedLimit = std::stod(spd);
-                    } catch (...) { }
-                }
-                double driveTime = dist / speedLimit;
-                timeRouter->AddEdge(srcTVert, destTVert, driveTime, false);
-                if (!isOneway)
-                    timeRouter->AddEdge(destTVert, srcTVert, driveTime, false);
+                AddTimeEdges(srcIndex, destIndex, dist, wayIndex);
             }
         }
         
         // Process direct ways (node count == 2).
         for (size_t i = 0; i < streetMap->WayCount(); ++i) {
-            auto way = streetMap->WayByIndex(i);
+            auto way = streetMap->WayPtrByIndex(i);
             if (way->NodeCount() != 2)
                 continue;
-            bool isOneway = false;
-            if (way->HasAttribute("oneway")) {
-                std::string val = way->GetAttribute("oneway");
-                isOneway = (val == "yes" || val == "true" || val == "1");
-            }
-            auto srcID = way->GetNodeID(0);
-            auto destID = way->GetNodeID(1);
-            if (srcID == CStreetMap::InvalidNodeID || destID == CStreetMap::InvalidNodeID)
-                continue;
-            auto srcNode = streetMap->NodeByID(srcID);
-            auto destNode = streetMap->NodeByID(destID);
-            if (!srcNode || !destNode)
-                continue;
-            double dist = SGeographicUtils::HaversineDistanceInMiles(srcNode->Location(), destNode->Location());
+            uint32_t wayIndex = AddWayRecord(*way);
+            bool isOneway = wayRouting[wayIndex].Has(SRoutingWay::Oneway);
+            WaySegmentLengths(*way, segmentLengths);
+            auto srcIndex = wayNodeIndices[0];
+            auto destIndex = wayNodeIndices[1];
+            double dist = segmentLengths[0];
             if (dist <= 0.0)
                 continue;
-            auto srcDVert = nodeToDistVertex[srcID];
-            auto destDVert = nodeToDistVertex[destID];
-            distRouter->AddEdge(srcDVert, destDVert, dist, false);
+            AddStreetEdges(srcIndex, destIndex, wayIndex, dist);
+            distRouter->AddEdge(indexVertex[srcIndex], indexVertex[destIndex], dist, false);
             if (!isOneway)
-                distRouter->AddEdge(destDVert, srcDVert, dist, false);
+                distRouter->AddEdge(indexVertex[destIndex], indexVertex[srcIndex], dist, false);
             
-            auto srcTVert = nodeToTimeVertex[srcID];
-            auto destTVert = nodeToTimeVertex[destID];
-            float walkTime = dist / configPtr->WalkSpeed();
-            timeRouter->AddEdge(srcTVert, destTVert, walkTime, false);
-            timeRouter->AddEdge(destTVert, srcTVert, walkTime, false);
-            float bikeTime = dist / configPtr->BikeSpeed();
-            timeRouter->AddEdge(srcTVert, destTVert, bikeTime, false);
-            if (!isOneway)
-                timeRouter->AddEdge(destTVert, srcTVert, bikeTime, false);
-            float speedLimit = configPtr->DefaultSpeedLimit();
-            if (way->HasAttribute("maxspeed")) {
-                try {
-                    std::string spd = way->GetAttribute("maxspeed");
-                    size_t pos = spd.find(' ');
-                    if (pos != std::string::npos)
-                        spd = spd.substr(0, pos);
-                    speedLimit = std::stof(spd);
-                } catch (...) { }
-            }
-            float driveTime = dist / speedLimit;
-            timeRouter->AddEdge(srcTVert, destTVert, driveTime, false);
-            if (!isOneway)
-                timeRouter->AddEdge(destTVert, srcTVert, driveTime, false);
+            AddTimeEdges(srcIndex, destIndex, dist, wayIndex);
         }
+        timer.Lap("way edges");
         
-        // Add bus route edges to the time router.
+        BuildStreetEdges();
+        timer.Lap("street graph");
+        BuildSpatialIndex();
+        timer.Lap("spatial index");
+        
+        // Add bus route edges, timed along the road geometry from the bus
+        // path store when one is available at the speed of each street.
+        std::vector<CStreetMap::TNodeID> busPath;
         for (const auto &entry : busRoutes) {
             CStreetMap::TNodeID nodeID = entry.first;
             for (const auto &routePair : entry.second) {
                 // Route name is not used here.
                 CStreetMap::TNodeID nextNodeID = routePair.second;
-                auto srcNode = streetMap->NodeByID(nodeID);
-                auto destNode = streetMap->NodeByID(nextNodeID);
-                if (!srcNode || !destNode)
+                size_t srcIndex = NodeIndex(nodeID);
+                size_t destIndex = NodeIndex(nextNodeID);
+                if (srcIndex == InvalidIndex || destIndex == InvalidIndex || nodeID == nextNodeID)
                     continue;
-                double dist = SGeographicUtils::HaversineDistanceInMiles(srcNode->Location(), destNode->Location());
-                double busTime = dist / configPtr->DefaultSpeedLimit() + (configPtr->BusStopTime() / 3600.0);
-                auto srcTVert = nodeToTimeVertex[nodeID];
-                auto destTVert = nodeToTimeVertex[nextNodeID];
-                timeRouter->AddEdge(srcTVert, destTVert, busTime, false);
+                STravelTime busTime(configPtr->BusStopTime());
+                AddBusLeg(nodeID, nextNodeID, busTime, busPath);
+                pendingTimeEdges.push_back({srcIndex, destIndex, BusLane, busTime.Total()});
             }
         }
+        timer.Lap("bus legs");
+        BuildTimeGraph();
+        timer.Lap("time graph");
+    }
+
+    // The hierarchy only serves bulk travel time trees, point to point
+    // queries still search the plain graph. It is built on the first request
+    // for trees within the configured precompute time, a build that misses
+    // the deadline is not retried and the trees fall back to plain searches.
+    void EnsureHierarchy() {
+        std::lock_guard<std::mutex> lock(hierarchyMutex);
+        if (hierarchyAttempted)
+            return;
+        hierarchyAttempted = true;
+        if (configPtr->PrecomputeTime() > 0)
+            timeRouter->Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(configPtr->PrecomputeTime()));
+    }
+
+    // Memory held by the planner's own tables and its routers
+    SConstructionReport Report() const {
+        using R = SConstructionReport;
+        SConstructionReport report;
+        report.DName = "CDijkstraTransportationPlanner";
+        report.DPhases = buildReport.DPhases;
+        report.AddComponent("nodes", orderedNodes.size(), R::VectorBytes(orderedNodes) + R::VectorBytes(orderedNodeSources) +
+                            R::VectorBytes(orderedNodeIDs) + R::VectorBytes(indexVertex) + R::VectorBytes(vertexIndex));
+        report.AddComponent("street edges", streetEdgeTargets.size(), R::VectorBytes(streetEdgeOffsets) +
+                            R::VectorBytes(streetEdgeTargets) + R::VectorBytes(streetEdgeWays) + R::VectorBytes(streetEdgeLengths) +
+                            R::VectorBytes(streetEdgeReverse) + R::VectorBytes(streetEdgeBearings));
+        report.AddComponent("time edges", timeEdgeTargets.size(), R::VectorBytes(timeEdgeOffsets) +
+                            R::VectorBytes(timeEdgeTargets) + timeEdgeBus.capacity() / 8);
+        size_t stringBytes = R::VectorBytes(wayStrings) + R::HashMapBytes(wayStringLookup);
+        for (const auto &str : wayStrings)
+            stringBytes += 2 * R::StringBytes(str);
+        report.AddComponent("ways", wayIDs.size(), R::VectorBytes(wayIDs) + R::VectorBytes(wayNames) + R::VectorBytes(wayMaxSpeeds) +
+                            R::VectorBytes(wayHighways) + R::VectorBytes(wayRouting));
+        report.AddComponent("way tag strings", wayStrings.size(), stringBytes);
+        size_t stopBytes = R::HashMapBytes(stopToNodeMap) + R::HashMapBytes(nodeToStop) + R::HashMapBytes(stopNames);
+        for (const auto &entry : stopNames)
+            stopBytes += R::StringBytes(entry.second);
+        report.AddComponent("bus stops", stopToNodeMap.size(), stopBytes);
+        // Tree nodes hold three pointers and a colour beside each element
+        size_t legs = 0;
+        size_t legBytes = R::HashMapBytes(busRoutes);
+        for (const auto &entry : busRoutes) {
+            legs += entry.second.size();
+            for (const auto &leg : entry.second)
+                legBytes += sizeof(leg) + 4 * sizeof(void *) + R::StringBytes(leg.first);
+        }
+        report.AddComponent("bus legs", legs, legBytes);
+        report.AddComponent("spatial index", spatialIndex->NodeCount(), spatialIndex->MemoryUsage());
+        report.AddComponent("segment index", segmentIndex->SegmentCount(), segmentIndex->MemoryUsage() + R::VectorBytes(segmentEdges));
+        if (pathCache) {
+            auto cache = pathCache->Statistics();
+            report.AddComponent("path cache", cache.DEntries, cache.DCompressedBytes);
+        }
+        for (const auto &router : {std::make_pair("distance router", distRouter), std::make_pair("time router", timeRouter),
+                                   std::make_pair("bike router", bikeRouter)}) {
+            SConstructionReport routerReport;
+            router.second->ConstructionReport(routerReport);
+            routerReport.DName = router.first;
+            report.AddComponents(routerReport);
+        }
+        return report;
+    }
+
+    // Sorted index of a node, InvalidIndex if it is not on the map
+    size_t NodeIndex(CStreetMap::TNodeID id) const {
+        auto search = std::lower_bound(orderedNodeIDs.begin(), orderedNodeIDs.end(), id);
+        if (search == orderedNodeIDs.end() || *search != id)
+            return InvalidIndex;
+        return search - orderedNodeIDs.begin();
+    }
+
+    // Router vertex of a node, the same in every router
+    CPathRouter::TVertexID NodeVertex(CStreetMap::TNodeID id) const {
+        size_t index = NodeIndex(id);
+        return index == InvalidIndex ? CPathRouter::InvalidVertexID : indexVertex[index];
+    }
+
+    // Lengths between consecutive nodes of a way in one batch, -1 where
+    // either node is not on the map
+    void WaySegmentLengths(const CStreetMap::SWay &way, std::vector<double> &lengths) {
+        size_t count = way.NodeCount();
+        wayLocations.resize(count);
+        wayNodeIndices.resize(count);
+        for (size_t j = 0; j < count; ++j) {
+            wayNodeIndices[j] = NodeIndex(way.GetNodeID(j));
+            wayLocations[j] = wayNodeIndices[j] != InvalidIndex ? orderedNodes[wayNodeIndices[j]]->Location() : CStreetMap::TLocation(0.0, 0.0);
+        }
+        lengths.resize(count > 0 ? count - 1 : 0);
+        SGeographicUtils::HaversinePolylineInMiles(wayLocations.data(), count, lengths.data());
+        for (size_t j = 1; j < count; ++j) {
+            if (wayNodeIndices[j - 1] == InvalidIndex || wayNodeIndices[j] == InvalidIndex)
+                lengths[j - 1] = -1.0;
+        }
+    }
+
+    uint32_t InternWayString(const std::string &str) {
+        auto search = wayStringLookup.find(str);
+        if (search != wayStringLookup.end())
+            return search->second;
+        uint32_t index = wayStrings.size();
+        wayStrings.push_back(str);
+        wayStringLookup[str] = index;
+        return index;
+    }
+
+    uint32_t AddWayRecord(const CStreetMap::SWay &way) {
+        wayIDs.push_back(way.ID());
+        wayNames.push_back(InternWayString(way.GetAttribute("name")));
+        wayMaxSpeeds.push_back(InternWayString(way.GetAttribute("maxspeed")));
+        wayHighways.push_back(InternWayString(way.GetAttribute("highway")));
+        wayRouting.push_back(SRoutingWay::FromWay(way, configPtr->DefaultSpeedLimit()));
+        return wayIDs.size() - 1;
+    }
+
+    // Lane costs come from the routing profiles, so access rules such as
+    // oneway streets or motorways closed to walking live in one place.
+    void AddTimeEdges(size_t srcIndex, size_t destIndex, double dist, uint32_t wayIndex) {
+        AddLaneEdges<SPedestrianProfile>(WalkLane, srcIndex, destIndex, dist, wayRouting[wayIndex]);
+        AddLaneEdges<SBicycleProfile>(BikeLane, srcIndex, destIndex, dist, wayRouting[wayIndex]);
+    }
+
+    template <typename TProfile>
+    void AddLaneEdges(ETimeLane lane, size_t srcIndex, size_t destIndex, double dist, const SRoutingWay &way) {
+        double forward = ProfileEdgeCost<TProfile>(way, false, dist, routingSpeeds);
+        double backward = ProfileEdgeCost<TProfile>(way, true, dist, routingSpeeds);
+        if (forward < std::numeric_limits<double>::infinity())
+            pendingTimeEdges.push_back({srcIndex, destIndex, lane, forward});
+        if (backward < std::numeric_limits<double>::infinity())
+            pendingTimeEdges.push_back({destIndex, srcIndex, lane, backward});
+    }
+
+    // Merges the pending time edges into one multi-lane edge per node pair,
+    // keeping the cheapest cost per lane, and derives the profile routers.
+    // The lane costs are dropped once the routers have them.
+    void BuildTimeGraph() {
+        std::stable_sort(pendingTimeEdges.begin(), pendingTimeEdges.end(),
+            [](const SPendingTimeEdge &a, const SPendingTimeEdge &b) {
+                return a.src < b.src || (a.src == b.src && a.dest < b.dest);
+            });
+        TLaneCosts noCosts;
+        noCosts.fill(std::numeric_limits<double>::infinity());
+        std::vector<TLaneCosts> timeEdgeCosts;
+        timeEdgeOffsets.assign(orderedNodes.size() + 1, 0);
+        for (size_t i = 0; i < pendingTimeEdges.size(); ++i) {
+            const auto &edge = pendingTimeEdges[i];
+            if (i == 0 || pendingTimeEdges[i-1].src != edge.src || pendingTimeEdges[i-1].dest != edge.dest) {
+                timeEdgeOffsets[edge.src + 1]++;
+                timeEdgeTargets.push_back(edge.dest);
+                timeEdgeCosts.push_back(noCosts);
+            }
+            double &cost = timeEdgeCosts.back()[edge.lane];
+            cost = std::min(cost, edge.cost);
+        }
+        for (size_t i = 1; i < timeEdgeOffsets.size(); ++i)
+            timeEdgeOffsets[i] += timeEdgeOffsets[i-1];
+        pendingTimeEdges.clear();
+        pendingTimeEdges.shrink_to_fit();
+
+        timeEdgeBus.resize(timeEdgeTargets.size());
+        for (size_t src = 0; src < orderedNodes.size(); ++src) {
+            for (size_t e = timeEdgeOffsets[src]; e < timeEdgeOffsets[src + 1]; ++e) {
+                const auto &costs = timeEdgeCosts[e];
+                double transitCost = std::min(costs[WalkLane], costs[BusLane]);
+                if (transitCost < std::numeric_limits<double>::infinity())
+                    timeRouter->AddEdge(indexVertex[src], indexVertex[timeEdgeTargets[e]], transitCost, false);
+                if (costs[BikeLane] < std::numeric_limits<double>::infinity())
+                    bikeRouter->AddEdge(indexVertex[src], indexVertex[timeEdgeTargets[e]], costs[BikeLane], false);
+                timeEdgeBus[e] = costs[BusLane] < costs[WalkLane];
+            }
+        }
+    }
+
+    // Returns the time edge index from one sorted node index to another, or
+    // timeEdgeTargets.size() if there is none.
+    size_t FindTimeEdge(size_t srcIndex, size_t destIndex) const {
+        for (size_t e = timeEdgeOffsets[srcIndex]; e < timeEdgeOffsets[srcIndex + 1]; ++e) {
+            if (timeEdgeTargets[e] == destIndex)
+                return e;
+        }
+        return timeEdgeTargets.size();
+    }
+
+    void AddStreetEdges(size_t srcIndex, size_t destIndex, uint32_t wayIndex, double dist) {
+        pendingStreetEdges.push_back({srcIndex, destIndex, wayIndex, dist, false});
+        pendingStreetEdges.push_back({destIndex, srcIndex, wayIndex, dist, true});
+    }
+
+    // Sorts the recorded street edges by source and target node and packs
+    // them. Every way sharing a segment keeps its own edge so each profile
+    // can use whichever it is allowed on, named ways sort first so the
+    // lookups by node pair find a name when there is one.
+    void BuildStreetEdges() {
+        std::stable_sort(pendingStreetEdges.begin(), pendingStreetEdges.end(),
+            [this](const SPendingStreetEdge &a, const SPendingStreetEdge &b) {
+                if (a.src != b.src)
+                    return a.src < b.src;
+                if (a.dest != b.dest)
+                    return a.dest < b.dest;
+                return wayNames[a.way] != 0 && wayNames[b.way] == 0;
+            });
+        streetEdgeOffsets.assign(orderedNodes.size() + 1, 0);
+        for (const auto &edge : pendingStreetEdges) {
+            streetEdgeOffsets[edge.src + 1]++;
+            streetEdgeTargets.push_back(edge.dest);
+            streetEdgeWays.push_back(edge.way);
+            streetEdgeLengths.push_back(edge.length);
+            streetEdgeReverse.push_back(edge.reverse);
+            streetEdgeBearings.push_back(std::lround(SGeographicUtils::CalculateBearing(orderedNodes[edge.src]->Location(),
+                                                                                       orderedNodes[edge.dest]->Location()) * 100.0));
+        }
+        for (size_t i = 1; i < streetEdgeOffsets.size(); ++i)
+            streetEdgeOffsets[i] += streetEdgeOffsets[i-1];
+        pendingStreetEdges.clear();
+        pendingStreetEdges.shrink_to_fit();
+    }
+
+    // Only nodes on the street graph are worth snapping to
+    void BuildSpatialIndex() {
+        std::vector<std::pair<CStreetMap::TNodeID, CStreetMap::TLocation>> nodes;
+        std::vector<CSegmentIndex::SSegment> segments;
+        for (size_t i = 0; i < orderedNodes.size(); ++i) {
+            if (streetEdgeOffsets[i] != streetEdgeOffsets[i + 1])
+                nodes.push_back({orderedNodes[i]->ID(), orderedNodes[i]->Location()});
+            for (size_t e = streetEdgeOffsets[i]; e < streetEdgeOffsets[i + 1]; ++e) {
+                // Parallel ways are snapped to as one segment
+                if (i < streetEdgeTargets[e] && (e == streetEdgeOffsets[i] || streetEdgeTargets[e - 1] != streetEdgeTargets[e])) {
+                    segments.push_back({orderedNodes[i]->Location(), orderedNodes[streetEdgeTargets[e]]->Location()});
+                    segmentEdges.push_back(e);
+                }
+            }
+        }
+        spatialIndex = std::make_unique<CSpatialIndex>(nodes);
+        segmentIndex = std::make_unique<CSegmentIndex>(segments);
+    }
+
+    // A location projected onto the street segment from start to end, edge
+    // is the first street edge between them
+    struct SSnap {
+        size_t edge;
+        size_t start;
+        size_t end;
+        double fraction;
+        CStreetMap::TLocation location;
+        double startDistance;
+        double endDistance;
+    };
+
+    bool SnapLocation(CStreetMap::TLocation loc, SSnap &snap) const {
+        CSegmentIndex::SMatch match;
+        if (!segmentIndex->NearestSegment(loc, match))
+            return false;
+        snap.edge = segmentEdges[match.DSegment];
+        snap.end = streetEdgeTargets[snap.edge];
+        snap.start = std::upper_bound(streetEdgeOffsets.begin(), streetEdgeOffsets.end(), snap.edge) - streetEdgeOffsets.begin() - 1;
+        snap.fraction = match.DFraction;
+        snap.location = match.DLocation;
+        snap.startDistance = SGeographicUtils::HaversineDistanceInMiles(orderedNodes[snap.start]->Location(), snap.location);
+        snap.endDistance = SGeographicUtils::HaversineDistanceInMiles(orderedNodes[snap.end]->Location(), snap.location);
+        return true;
+    }
+
+    // Cheapest TProfile cost of travelling distance along the snapped
+    // segment, towards its end or its start, over every way on it. INF if
+    // TProfile may not use any of them that way.
+    template <typename TProfile>
+    double SnapSegmentCost(const SSnap &snap, bool towardsEnd, double distance) const {
+        double cost = std::numeric_limits<double>::infinity();
+        for (size_t e = streetEdgeOffsets[snap.start]; e < streetEdgeOffsets[snap.start + 1]; ++e) {
+            if (streetEdgeTargets[e] != snap.end)
+                continue;
+            bool reverse = streetEdgeReverse[e];
+            cost = std::min(cost, ProfileEdgeCost<TProfile>(wayRouting[streetEdgeWays[e]], towardsEnd ? reverse : !reverse,
+                                                            distance, routingSpeeds));
+        }
+        return cost;
+    }
+
+    // Seeds for the router whose vertices vertexOf maps node indices to,
+    // leaving the snapped point when outgoing and arriving at it otherwise,
+    // costed by TProfile over the part of the segment travelled.
+    template <typename TProfile, typename TVertexOf>
+    std::vector<std::pair<CPathRouter::TVertexID, double>> SnapSeeds(const SSnap &snap, bool outgoing, TVertexOf vertexOf) const {
+        std::vector<std::pair<CPathRouter::TVertexID, double>> seeds;
+        double toEnd = SnapSegmentCost<TProfile>(snap, outgoing, snap.endDistance);
+        double toStart = SnapSegmentCost<TProfile>(snap, !outgoing, snap.startDistance);
+        if (toEnd < std::numeric_limits<double>::infinity())
+            seeds.push_back({vertexOf(snap.end), toEnd});
+        if (toStart < std::numeric_limits<double>::infinity())
+            seeds.push_back({vertexOf(snap.start), toStart});
+        return seeds;
+    }
+
+    // Cost of going straight along a shared segment from one snapped point
+    // to another without reaching either end, INF if they are on different
+    // segments or TProfile may not go that way.
+    template <typename TProfile>
+    double SnapDirectCost(const SSnap &src, const SSnap &dest) const {
+        if (src.edge != dest.edge)
+            return std::numeric_limits<double>::infinity();
+        return SnapSegmentCost<TProfile>(src, dest.fraction >= src.fraction,
+                                         SGeographicUtils::HaversineDistanceInMiles(src.location, dest.location));
+    }
+
+    // Returns the first street edge from one sorted node index to another,
+    // on a named way if any shares the segment, or streetEdgeTargets.size()
+    // if the nodes are not adjacent.
+    size_t FindStreetEdge(size_t srcIndex, size_t destIndex) const {
+        for (size_t e = streetEdgeOffsets[srcIndex]; e < streetEdgeOffsets[srcIndex + 1]; ++e) {
+            if (streetEdgeTargets[e] == destIndex)
+                return e;
+        }
+        return streetEdgeTargets.size();
+    }
+
+    // Length of travel between two sorted node indices, read from the street
+    // edge when they are adjacent. Edge lengths are the exact Haversine
+    // distances so times summed from them match the graph weights.
+    double StepLength(size_t srcIndex, size_t destIndex, size_t edge) const {
+        if (edge < streetEdgeTargets.size())
+            return streetEdgeLengths[edge];
+        return SGeographicUtils::HaversineDistanceInMiles(orderedNodes[srcIndex]->Location(), orderedNodes[destIndex]->Location());
+    }
+
+    double StepLength(CStreetMap::TNodeID srcID, CStreetMap::TNodeID destID) const {
+        size_t srcIndex = NodeIndex(srcID);
+        size_t destIndex = NodeIndex(destID);
+        return StepLength(srcIndex, destIndex, FindStreetEdge(srcIndex, destIndex));
+    }
+
+    // Road path driven by bus between two stop nodes, the stored geometry if
+    // there is a complete one and otherwise the straight leg.
+    void BusLegPath(CStreetMap::TNodeID src, CStreetMap::TNodeID dest,
+                    std::vector<CStreetMap::TNodeID> &pathBuffer) const {
+        if (busPaths && busPaths->GetPath(src, dest, pathBuffer)) {
+            bool complete = true;
+            for (const auto &nodeID : pathBuffer) {
+                if (NodeIndex(nodeID) == InvalidIndex) {
+                    complete = false;
+                    break;
+                }
+            }
+            if (complete)
+                return;
+        }
+        pathBuffer.assign({src, dest});
+    }
+
+    // Adds one bus leg, including its stop, driven at the speed limit of each
+    // street it follows (the default where it leaves the streets).
+    void AddBusLeg(CStreetMap::TNodeID src, CStreetMap::TNodeID dest, STravelTime &travel,
+                   std::vector<CStreetMap::TNodeID> &pathBuffer) const {
+        BusLegPath(src, dest, pathBuffer);
+        for (size_t i = 1; i < pathBuffer.size(); ++i) {
+            size_t srcIndex = NodeIndex(pathBuffer[i-1]);
+            size_t destIndex = NodeIndex(pathBuffer[i]);
+            size_t edge = FindStreetEdge(srcIndex, destIndex);
+            double speed = edge < streetEdgeTargets.size() ? SBusProfile::Speed(wayRouting[streetEdgeWays[edge]], routingSpeeds)
+                                                           : configPtr->DefaultSpeedLimit();
+            travel.Add(BusLane, speed, StepLength(srcIndex, destIndex, edge));
+            // The stop belongs to the bus stretch, not the one before it
+            if (i == 1)
+                travel.AddStop();
+        }
     }
     
     std::string FindBusRouteBetweenNodes(const CStreetMap::TNodeID& src,
@@ -226,6 +726,366 @@ struct CDijkstraTransportationPlanner::SImplementation {
         }
         return "";
     }
+
+    struct SLegInfo {
+        uint32_t name;
+        double bearing;
+        double distance;
+    };
+
+    // Street name, bearing and length for travel between two sorted node
+    // indices, taken from the street edges when the nodes are adjacent.
+    void LegInfo(size_t srcIndex, size_t destIndex, SLegInfo &leg) const {
+        size_t edge = FindStreetEdge(srcIndex, destIndex);
+        leg.distance = StepLength(srcIndex, destIndex, edge);
+        if (edge < streetEdgeTargets.size()) {
+            leg.name = wayNames[streetEdgeWays[edge]];
+            leg.bearing = streetEdgeBearings[edge] / 100.0;
+        } else {
+            leg.name = 0;
+            leg.bearing = SGeographicUtils::CalculateBearing(orderedNodes[srcIndex]->Location(), orderedNodes[destIndex]->Location());
+        }
+    }
+
+    void RoutesBetweenNodes(CStreetMap::TNodeID src, CStreetMap::TNodeID dest, std::vector<std::string> &routes) const {
+        routes.clear();
+        auto search = busRoutes.find(src);
+        if (search == busRoutes.end())
+            return;
+        // The set is ordered by route name so the result is sorted.
+        for (const auto &entry : search->second) {
+            if (entry.second == dest)
+                routes.push_back(entry.first);
+        }
+    }
+
+    void AppendBusDescription(const std::string &route, CStreetMap::TNodeID src, CStreetMap::TNodeID dest,
+                              std::vector<std::string> &desc) const {
+        desc.emplace_back("Take Bus ");
+        auto &line = desc.back();
+        line += route;
+        line += " from stop ";
+        line += std::to_string(nodeToStop.at(src));
+        line += " to stop ";
+        line += std::to_string(nodeToStop.at(dest));
+    }
+
+    // Describes the bus ride through path[first] .. path[last - 1]. Nodes
+    // that are not stops (expanded bus geometry) are passed through, and a
+    // new line is started whenever no single route covers the next hop.
+    bool DescribeBusRun(const std::vector<TTripStep> &path, size_t first, size_t last,
+                        std::vector<std::string> &desc) const {
+        CStreetMap::TNodeID segmentStart = path[first].second;
+        CStreetMap::TNodeID currentStop = segmentStart;
+        if (nodeToStop.count(segmentStart) == 0)
+            return false;
+        std::vector<std::string> candidates, hopRoutes, common;
+        for (size_t k = first + 1; k < last; ++k) {
+            CStreetMap::TNodeID nodeID = path[k].second;
+            if (nodeToStop.count(nodeID) == 0)
+                continue;
+            RoutesBetweenNodes(currentStop, nodeID, hopRoutes);
+            if (hopRoutes.empty())
+                continue;
+            if (candidates.empty()) {
+                candidates.swap(hopRoutes);
+            } else {
+                common.clear();
+                std::set_intersection(candidates.begin(), candidates.end(), hopRoutes.begin(), hopRoutes.end(),
+                                      std::back_inserter(common));
+                if (common.empty()) {
+                    AppendBusDescription(candidates.front(), segmentStart, currentStop, desc);
+                    segmentStart = currentStop;
+                    candidates.swap(hopRoutes);
+                } else {
+                    candidates.swap(common);
+                }
+            }
+            currentStop = nodeID;
+        }
+        if (candidates.empty() || currentStop != path[last - 1].second)
+            return false;
+        AppendBusDescription(candidates.front(), segmentStart, currentStop, desc);
+        return true;
+    }
+
+    // Resolves the way each consecutive node pair lies on, way indices are
+    // set to wayIDs.size() for pairs that are not street segments.
+    bool PathWayIndices(const std::vector<CStreetMap::TNodeID> &path, std::vector<size_t> &ways) const {
+        ways.clear();
+        if (path.empty())
+            return false;
+        ways.reserve(path.size() - 1);
+        bool complete = true;
+        size_t prev = NodeIndex(path[0]);
+        if (prev == InvalidIndex)
+            return false;
+        for (size_t i = 1; i < path.size(); ++i) {
+            size_t curr = NodeIndex(path[i]);
+            if (curr == InvalidIndex)
+                return false;
+            size_t edge = FindStreetEdge(prev, curr);
+            if (edge < streetEdgeTargets.size()) {
+                ways.push_back(streetEdgeWays[edge]);
+            } else {
+                ways.push_back(wayIDs.size());
+                complete = false;
+            }
+            prev = curr;
+        }
+        return complete;
+    }
+
+    // Single pass over the steps: consecutive walk or bike steps along the
+    // same street are merged, bus runs are described stop to stop.
+    bool DescribePath(const std::vector<TTripStep> &path, std::vector<std::string> &desc) const {
+        desc.clear();
+        if (path.empty())
+            return false;
+        std::vector<size_t> indices(path.size());
+        for (size_t i = 0; i < path.size(); ++i) {
+            indices[i] = NodeIndex(path[i].second);
+            if (indices[i] == InvalidIndex)
+                return false;
+        }
+        // legs[i] describes travel from step i - 1 to step i, nextNames[i]
+        // is the first street name at or after step i for "toward" lines.
+        std::vector<SLegInfo> legs(path.size());
+        for (size_t i = 1; i < path.size(); ++i)
+            LegInfo(indices[i-1], indices[i], legs[i]);
+        std::vector<uint32_t> nextNames(path.size() + 1, 0);
+        for (size_t i = path.size(); i-- > 1;) {
+            bool named = legs[i].name != 0 && path[i].first != ETransportationMode::Bus;
+            nextNames[i] = named ? legs[i].name : nextNames[i+1];
+        }
+
+        desc.reserve(path.size() + 1);
+        desc.push_back("Start at " + SGeographicUtils::ConvertLLToDMS(orderedNodes[indices.front()]->Location()));
+        char distanceBuffer[32];
+        size_t i = 1;
+        while (i < path.size()) {
+            ETransportationMode mode = path[i].first;
+            size_t end = i + 1;
+            if (mode == ETransportationMode::Bus) {
+                while (end < path.size() && path[end].first == ETransportationMode::Bus)
+                    ++end;
+                if (!DescribeBusRun(path, i - 1, end, desc))
+                    return false;
+                i = end;
+                continue;
+            }
+            double distance = legs[i].distance;
+            while (end < path.size() && path[end].first == mode && legs[end].name == legs[i].name) {
+                distance += legs[end].distance;
+                ++end;
+            }
+            desc.emplace_back(mode == ETransportationMode::Walk ? "Walk " : "Bike ");
+            auto &line = desc.back();
+            line += SGeographicUtils::BearingToDirection(legs[i].bearing);
+            if (legs[i].name) {
+                line += " along ";
+                line += wayStrings[legs[i].name];
+            } else {
+                line += " toward ";
+                line += nextNames[end] ? wayStrings[nextNames[end]] : std::string("End");
+            }
+            std::snprintf(distanceBuffer, sizeof(distanceBuffer), " for %.1f mi", distance);
+            line += distanceBuffer;
+            i = end;
+        }
+        desc.push_back("End at " + SGeographicUtils::ConvertLLToDMS(orderedNodes[indices.back()]->Location()));
+        return true;
+    }
+
+    // Results only depend on the routers, so their modification counts
+    // identify the graph a cached entry was computed on. Every change bumps
+    // exactly one count by one, so the sum never repeats an earlier value.
+    std::uint64_t GraphGeneration() const {
+        return static_cast<std::uint64_t>(distRouter->ModificationCount()) + bikeRouter->ModificationCount() +
+               timeRouter->ModificationCount();
+    }
+
+    double ComputeShortestPath(TNodeID src, TNodeID dest, std::vector<TNodeID> &path) {
+        path.clear();
+        auto srcVertex = NodeVertex(src);
+        auto destVertex = NodeVertex(dest);
+        if (srcVertex == CPathRouter::InvalidVertexID || destVertex == CPathRouter::InvalidVertexID)
+            return CPathRouter::NoPathExists;
+        
+        std::vector<CPathRouter::TVertexID> routerPath;
+        double distance = distRouter->FindShortestPath(srcVertex, destVertex, routerPath);
+        if (distance < 0.0)
+            return CPathRouter::NoPathExists;
+        
+        path.resize(routerPath.size());
+        for (size_t i = 0; i < routerPath.size(); ++i)
+            path[i] = distRouter->VertexTag(routerPath[i]);
+        return distance;
+    }
+
+    double ComputeFastestPath(TNodeID src, TNodeID dest, std::vector<TTripStep> &path) {
+        path.clear();
+        if (src == dest) {
+            path.push_back({ETransportationMode::Walk, src});
+            return 0.0;
+        }
+        // A trip either cycles the whole way or walks and rides the bus, each
+        // profile is searched on its own router and the quicker one is kept.
+        auto srcVertex = NodeVertex(src);
+        auto destVertex = NodeVertex(dest);
+        if (srcVertex == CPathRouter::InvalidVertexID || destVertex == CPathRouter::InvalidVertexID)
+            return CPathRouter::NoPathExists;
+        std::vector<CPathRouter::TVertexID> routerPath;
+        std::vector<TTripStep> transitPath;
+        double bikeTime = CPathRouter::NoPathExists;
+        double transitTime = CPathRouter::NoPathExists;
+        if (bikeRouter->FindShortestPath(srcVertex, destVertex, routerPath) != CPathRouter::NoPathExists)
+            bikeTime = TimeBikePath(routerPath, path);
+        if (timeRouter->FindShortestPath(srcVertex, destVertex, routerPath) != CPathRouter::NoPathExists)
+            transitTime = TimeTransitPath(routerPath, transitPath);
+        if (transitTime < bikeTime) {
+            path.swap(transitPath);
+            return transitTime;
+        }
+        if (bikeTime == CPathRouter::NoPathExists)
+            path.clear();
+        return bikeTime;
+    }
+
+    // Shortest distance between two locations snapped onto the streets, the
+    // path holds the nodes passed in between which is empty when both lie
+    // on the same edge.
+    double ComputeShortestPath(CStreetMap::TLocation srcLoc, CStreetMap::TLocation destLoc, std::vector<TNodeID> &path) {
+        path.clear();
+        SSnap src, dest;
+        if (!SnapLocation(srcLoc, src) || !SnapLocation(destLoc, dest))
+            return CPathRouter::NoPathExists;
+        auto distVertexOf = [this](size_t index) { return indexVertex[index]; };
+        std::vector<CPathRouter::TVertexID> routerPath;
+        double distance = distRouter->FindShortestPathBetweenSets(SnapSeeds<SDistanceProfile>(src, true, distVertexOf),
+                                                                  SnapSeeds<SDistanceProfile>(dest, false, distVertexOf), routerPath);
+        double direct = SnapDirectCost<SDistanceProfile>(src, dest);
+        if (direct <= distance)
+            return direct;
+        for (const auto &vID : routerPath)
+            path.push_back(distRouter->VertexTag(vID));
+        return distance;
+    }
+
+    // Fastest trip between two locations snapped onto the streets, walking
+    // or cycling the partial edges at either end.
+    double ComputeFastestPath(CStreetMap::TLocation srcLoc, CStreetMap::TLocation destLoc, std::vector<TTripStep> &path) {
+        path.clear();
+        SSnap src, dest;
+        if (!SnapLocation(srcLoc, src) || !SnapLocation(destLoc, dest))
+            return CPathRouter::NoPathExists;
+        auto timeVertexOf = [this](size_t index) { return indexVertex[index]; };
+        std::vector<CPathRouter::TVertexID> routerPath;
+        std::vector<TTripStep> transitPath;
+        double bikeTime = SnapDirectCost<SBicycleProfile>(src, dest);
+        double transitTime = SnapDirectCost<SPedestrianProfile>(src, dest);
+        auto bikeSources = SnapSeeds<SBicycleProfile>(src, true, timeVertexOf);
+        auto bikeTargets = SnapSeeds<SBicycleProfile>(dest, false, timeVertexOf);
+        if (bikeRouter->FindShortestPathBetweenSets(bikeSources, bikeTargets, routerPath) != CPathRouter::NoPathExists) {
+            std::vector<TTripStep> bikePath;
+            double time = TimeBikePath(routerPath, bikePath) + SeedCost(bikeSources, routerPath.front()) + SeedCost(bikeTargets, routerPath.back());
+            if (time < bikeTime) {
+                bikeTime = time;
+                path.swap(bikePath);
+            }
+        }
+        auto walkSources = SnapSeeds<SPedestrianProfile>(src, true, timeVertexOf);
+        auto walkTargets = SnapSeeds<SPedestrianProfile>(dest, false, timeVertexOf);
+        if (timeRouter->FindShortestPathBetweenSets(walkSources, walkTargets, routerPath) != CPathRouter::NoPathExists) {
+            double time = TimeTransitPath(routerPath, transitPath) + SeedCost(walkSources, routerPath.front()) + SeedCost(walkTargets, routerPath.back());
+            if (time < transitTime)
+                transitTime = time;
+            else
+                transitPath.clear();
+        }
+        if (transitTime < bikeTime) {
+            path.swap(transitPath);
+            return transitTime;
+        }
+        if (bikeTime == std::numeric_limits<double>::infinity()) {
+            path.clear();
+            return CPathRouter::NoPathExists;
+        }
+        return bikeTime;
+    }
+
+    static double SeedCost(const std::vector<std::pair<CPathRouter::TVertexID, double>> &seeds, CPathRouter::TVertexID vertex) {
+        double cost = std::numeric_limits<double>::infinity();
+        for (const auto &seed : seeds) {
+            if (seed.first == vertex)
+                cost = std::min(cost, seed.second);
+        }
+        return cost;
+    }
+
+    // Dispatches once to the search kernel instantiated for the profile
+    double ComputeProfilePath(ERoutingProfile profile, size_t srcIndex, size_t destIndex, std::vector<TNodeID> &path) const {
+        SStreetGraph graph{*this};
+        std::vector<size_t> indices;
+        double time = CPathRouter::NoPathExists;
+        switch (profile) {
+            case ERoutingProfile::Pedestrian:
+                time = ::FindProfilePath<SPedestrianProfile>(graph, routingSpeeds, srcIndex, destIndex, indices);
+                break;
+            case ERoutingProfile::Bicycle:
+                time = ::FindProfilePath<SBicycleProfile>(graph, routingSpeeds, srcIndex, destIndex, indices);
+                break;
+            case ERoutingProfile::Bus:
+                time = ::FindProfilePath<SBusProfile>(graph, routingSpeeds, srcIndex, destIndex, indices);
+                break;
+            case ERoutingProfile::Car:
+                time = ::FindProfilePath<SCarProfile>(graph, routingSpeeds, srcIndex, destIndex, indices);
+                break;
+            case ERoutingProfile::Wheelchair:
+                time = ::FindProfilePath<SWheelchairProfile>(graph, routingSpeeds, srcIndex, destIndex, indices);
+                break;
+        }
+        path.clear();
+        for (auto index : indices)
+            path.push_back(orderedNodes[index]->ID());
+        return time;
+    }
+
+    double TimeBikePath(const std::vector<CPathRouter::TVertexID> &routerPath, std::vector<TTripStep> &path) const {
+        STravelTime travel(configPtr->BusStopTime());
+        path.clear();
+        for (size_t i = 0; i < routerPath.size(); ++i) {
+            TNodeID nodeID = timeRouter->VertexTag(routerPath[i]);
+            path.push_back({ETransportationMode::Bike, nodeID});
+            if (i > 0)
+                travel.Add(BikeLane, configPtr->BikeSpeed(), StepLength(path[i-1].second, nodeID));
+        }
+        return travel.Total();
+    }
+
+    // Each hop takes whichever of walking and the bus its edge was weighted
+    // by, bus legs are expanded into the road path so every step is a node
+    // actually travelled through.
+    double TimeTransitPath(const std::vector<CPathRouter::TVertexID> &routerPath, std::vector<TTripStep> &path) const {
+        STravelTime travel(configPtr->BusStopTime());
+        std::vector<TNodeID> busPath;
+        path.clear();
+        TNodeID previous = timeRouter->VertexTag(routerPath.front());
+        path.push_back({ETransportationMode::Walk, previous});
+        for (size_t i = 1; i < routerPath.size(); ++i) {
+            TNodeID nodeID = timeRouter->VertexTag(routerPath[i]);
+            if (timeEdgeBus[FindTimeEdge(vertexIndex[routerPath[i-1]], vertexIndex[routerPath[i]])]) {
+                AddBusLeg(previous, nodeID, travel, busPath);
+                for (size_t j = 1; j < busPath.size(); ++j)
+                    path.push_back({ETransportationMode::Bus, busPath[j]});
+            } else {
+                travel.Add(WalkLane, configPtr->WalkSpeed(), StepLength(previous, nodeID));
+                path.push_back({ETransportationMode::Walk, nodeID});
+            }
+            previous = nodeID;
+        }
+        return travel.Total();
+    }
 };
 
 CDijkstraTransportationPlanner::CDijkstraTransportationPlanner(std::shared_ptr<SConfiguration> config)
@@ -239,100 +1099,185 @@ std::size_t CDijkstraTransportationPlanner::NodeCount() const noexcept {
 }
 
 std::shared_ptr<CStreetMap::SNode> CDijkstraTransportationPlanner::SortedNodeByIndex(std::size_t index) const noexcept {
+    if (index < DImplementation->orderedNodes.size())
+        return DImplementation->configPtr->StreetMap()->NodeByIndex(DImplementation->orderedNodeSources[index]);
+    return nullptr;
+}
+
+const CStreetMap::SNode *CDijkstraTransportationPlanner::SortedNodePtrByIndex(std::size_t index) const noexcept {
     if (index < DImplementation->orderedNodes.size())
         return DImplementation->orderedNodes[index];
     return nullptr;
 }
 
 double CDijkstraTransportationPlanner::FindShortestPath(TNodeID src, TNodeID dest, std::vector<TNodeID> &path) {
-    path.clear();
-    if (DImplementation->nodeToDistVertex.find(src) == DImplementation->nodeToDistVertex.end() ||
-        DImplementation->nodeToDistVertex.find(dest) == DImplementation->nodeToDistVertex.end())
-        return CPathRouter::NoPathExists;
-    
-    auto srcVertex = DImplementation->nodeToDistVertex[src];
-    auto destVertex = DImplementation->nodeToDistVertex[dest];
-    std::vector<CPathRouter::TVertexID> routerPath;
-    double distance = DImplementation->distRouter->FindShortestPath(srcVertex, destVertex, routerPath);
-    if (distance < 0.0)
-        return CPathRouter::NoPathExists;
-    
-    for (const auto &vID : routerPath)
-        path.insert(path.begin(), DImplementation->distVertexToNode[vID]);
-    std::reverse(path.begin(), path.end());
+    auto &cache = DImplementation->pathCache;
+    std::vector<TTripStep> cachedSteps;
+    double distance;
+    if (cache && cache->Lookup(src, dest, CPathCache::EMetric::Distance, DImplementation->GraphGeneration(), distance, cachedSteps)) {
+        path.clear();
+        for (const auto &step : cachedSteps)
+            path.push_back(step.second);
+        return distance;
+    }
+    distance = DImplementation->ComputeShortestPath(src, dest, path);
+    if (cache) {
+        for (const auto &nodeID : path)
+            cachedSteps.push_back({ETransportationMode::Walk, nodeID});
+        cache->Insert(src, dest, CPathCache::EMetric::Distance, DImplementation->GraphGeneration(), distance, cachedSteps);
+    }
     return distance;
 }
 
 double CDijkstraTransportationPlanner::FindFastestPath(TNodeID src, TNodeID dest, std::vector<TTripStep> &path) {
-    path.clear();
-    if (src == dest) {
-        path.push_back({ETransportationMode::Walk, src});
-        return 0.0;
+    auto &cache = DImplementation->pathCache;
+    double time;
+    if (cache && cache->Lookup(src, dest, CPathCache::EMetric::Time, DImplementation->GraphGeneration(), time, path))
+        return time;
+    time = DImplementation->ComputeFastestPath(src, dest, path);
+    if (cache)
+        cache->Insert(src, dest, CPathCache::EMetric::Time, DImplementation->GraphGeneration(), time, path);
+    return time;
+}
+
+bool CDijkstraTransportationPlanner::GetPathWays(const std::vector<TNodeID> &path, std::vector<CStreetMap::TWayID> &ways) const {
+    std::vector<size_t> wayIndices;
+    bool complete = DImplementation->PathWayIndices(path, wayIndices);
+    ways.assign(wayIndices.size(), CStreetMap::TWayID(CStreetMap::InvalidWayID));
+    for (size_t i = 0; i < wayIndices.size(); ++i) {
+        if (wayIndices[i] < DImplementation->wayIDs.size())
+            ways[i] = DImplementation->wayIDs[wayIndices[i]];
     }
-    if (DImplementation->nodeToDistVertex.find(src) == DImplementation->nodeToDistVertex.end() ||
-        DImplementation->nodeToDistVertex.find(dest) == DImplementation->nodeToDistVertex.end())
-        return CPathRouter::NoPathExists;
-    
-    // Use the time router solely to derive the node sequence.
-    auto srcVertex = DImplementation->nodeToTimeVertex[src];
-    auto destVertex = DImplementation->nodeToTimeVertex[dest];
-    std::vector<CPathRouter::TVertexID> routerPath;
-    // (Ignore the returned time from the router.)
-    DImplementation->timeRouter->FindShortestPath(srcVertex, destVertex, routerPath);
-    if (routerPath.size() < 2)
-        return CPathRouter::NoPathExists;
-    
-    std::vector<TNodeID> nodeSequence;
-    for (const auto &vertex : routerPath)
-        nodeSequence.push_back(DImplementation->timeVertexToNode[vertex]);
-    
-    // Dynamically build the trip path and recalculate the total travel time.
-    double computedTime = 0.0;
-    ETransportationMode lastMode = ETransportationMode::Walk;
-    path.push_back({lastMode, nodeSequence[0]});
-    
-    for (size_t i = 1; i < nodeSequence.size(); ++i) {
-        auto prevNode = DImplementation->configPtr->StreetMap()->NodeByID(nodeSequence[i-1]);
-        auto currNode = DImplementation->configPtr->StreetMap()->NodeByID(nodeSequence[i]);
-        if (!prevNode || !currNode)
-            continue;
-        
-        float segDistance = SGeographicUtils::HaversineDistanceInMiles(prevNode->Location(), currNode->Location());
-        float walkDuration = segDistance / DImplementation->configPtr->WalkSpeed();
-        float bikeDuration = segDistance / DImplementation->configPtr->BikeSpeed();
-        float busDuration = std::numeric_limits<float>::max();
-        std::string busOption = DImplementation->FindBusRouteBetweenNodes(nodeSequence[i-1], nodeSequence[i]);
-        if (!busOption.empty()) {
-            busDuration = segDistance / DImplementation->configPtr->DefaultSpeedLimit() +
-                          (DImplementation->configPtr->BusStopTime() / 3600.0);
-        }
-        
-        ETransportationMode chosenMode;
-        double segmentTime = 0.0;
-        if (!busOption.empty()) {
-            chosenMode = ETransportationMode::Bus;
-            segmentTime = busDuration;
-        } else if (bikeDuration < walkDuration) {
-            chosenMode = ETransportationMode::Bike;
-            segmentTime = bikeDuration;
+    return complete;
+}
+
+bool CDijkstraTransportationPlanner::GetPathWayInfo(const std::vector<TNodeID> &path, std::vector<SWayInfo> &info) const {
+    std::vector<size_t> wayIndices;
+    bool complete = DImplementation->PathWayIndices(path, wayIndices);
+    const auto &strings = DImplementation->wayStrings;
+    info.clear();
+    info.reserve(wayIndices.size());
+    for (auto wayIndex : wayIndices) {
+        if (wayIndex < DImplementation->wayIDs.size()) {
+            info.push_back({DImplementation->wayIDs[wayIndex],
+                            strings[DImplementation->wayNames[wayIndex]],
+                            strings[DImplementation->wayMaxSpeeds[wayIndex]],
+                            strings[DImplementation->wayHighways[wayIndex]]});
         } else {
-            chosenMode = ETransportationMode::Walk;
-            segmentTime = walkDuration;
+            info.push_back({CStreetMap::InvalidWayID, "", "", ""});
         }
-        
-        computedTime += segmentTime;
-        
-        if (chosenMode == lastMode)
-            path.back().second = nodeSequence[i];
-        else
-            path.push_back({chosenMode, nodeSequence[i]});
-        
-        lastMode = chosenMode;
     }
-    
-    return computedTime;
+    return complete;
 }
 
 bool CDijkstraTransportationPlanner::GetPathDescription(const std::vector<TTripStep> &path, std::vector<std::string> &desc) const {
+    return DImplementation->DescribePath(path, desc);
+}
+
+
+bool CDijkstraTransportationPlanner::FindIsochrone(TNodeID src, double maxtime, std::vector<std::pair<TNodeID, double>> &reached) {
+    reached.clear();
+    const auto &timeRouter = DImplementation->timeRouter;
+    auto srcVertex = DImplementation->NodeVertex(src);
+    if (srcVertex == CPathRouter::InvalidVertexID || maxtime < 0.0)
+        return false;
+    std::vector<std::pair<CPathRouter::TVertexID, double>> vertices;
+    timeRouter->FindVerticesWithinCost(srcVertex, maxtime, vertices);
+    reached.reserve(vertices.size());
+    for (const auto &vertex : vertices)
+        reached.push_back({timeRouter->VertexTag(vertex.first), vertex.second});
     return true;
 }
+
+bool CDijkstraTransportationPlanner::FindTravelTimeTrees(const std::vector<TNodeID> &sources, std::vector<std::vector<double>> &times) {
+    times.clear();
+    std::vector<CPathRouter::TVertexID> sourceVertices;
+    for (const auto &src : sources) {
+        auto srcVertex = DImplementation->NodeVertex(src);
+        if (srcVertex == CPathRouter::InvalidVertexID)
+            return false;
+        sourceVertices.push_back(srcVertex);
+    }
+    std::vector<std::vector<double>> vertexTimes;
+    DImplementation->EnsureHierarchy();
+    if (!DImplementation->timeRouter->FindShortestPathTrees(sourceVertices, vertexTimes))
+        return false;
+    const auto &indexVertex = DImplementation->indexVertex;
+    times.resize(sources.size());
+    for (size_t i = 0; i < sources.size(); ++i) {
+        times[i].resize(indexVertex.size());
+        for (size_t index = 0; index < indexVertex.size(); ++index)
+            times[i][index] = vertexTimes[i][indexVertex[index]];
+    }
+    return true;
+}
+
+double CDijkstraTransportationPlanner::FindShortestPathBetweenLocations(CStreetMap::TLocation src, CStreetMap::TLocation dest, std::vector<TNodeID> &path) {
+    return DImplementation->ComputeShortestPath(src, dest, path);
+}
+
+double CDijkstraTransportationPlanner::FindFastestPathBetweenLocations(CStreetMap::TLocation src, CStreetMap::TLocation dest, std::vector<TTripStep> &path) {
+    return DImplementation->ComputeFastestPath(src, dest, path);
+}
+
+CTransportationPlanner::TNodeID CDijkstraTransportationPlanner::NearestNode(CStreetMap::TLocation loc) const {
+    return DImplementation->spatialIndex->NearestNode(loc);
+}
+
+double CDijkstraTransportationPlanner::FindProfilePath(ERoutingProfile profile, TNodeID src, TNodeID dest, std::vector<TNodeID> &path) {
+    path.clear();
+    size_t srcIndex = DImplementation->NodeIndex(src);
+    size_t destIndex = DImplementation->NodeIndex(dest);
+    if (srcIndex == SImplementation::InvalidIndex || destIndex == SImplementation::InvalidIndex)
+        return CPathRouter::NoPathExists;
+    return DImplementation->ComputeProfilePath(profile, srcIndex, destIndex, path);
+}
+
+CPathCache::SStatistics CDijkstraTransportationPlanner::PathCacheStatistics() const noexcept {
+    if (!DImplementation->pathCache)
+        return CPathCache::SStatistics();
+    return DImplementation->pathCache->Statistics();
+}
+
+void CDijkstraTransportationPlanner::ClearPathCache() noexcept {
+    if (DImplementation->pathCache)
+        DImplementation->pathCache->Clear();
+}
+
+const CSpatialIndex &CDijkstraTransportationPlanner::SpatialIndex() const noexcept {
+    return *DImplementation->spatialIndex;
+}
+
+std::shared_ptr<CDijkstraPathRouter> CDijkstraTransportationPlanner::DistanceRouter() const noexcept {
+    return DImplementation->distRouter;
+}
+
+bool CDijkstraTransportationPlanner::ConstructionReports(std::vector<SConstructionReport> &reports) const {
+    reports.clear();
+    SConstructionReport report;
+    if (DImplementation->configPtr->StreetMap()->ConstructionReport(report))
+        reports.push_back(report);
+    if (DImplementation->configPtr->BusSystem()->ConstructionReport(report))
+        reports.push_back(report);
+    reports.push_back(DImplementation->Report());
+    return true;
+}
+
+void CDijkstraTransportationPlanner::SetSearchStatisticsEnabled(bool enable) noexcept {
+    DImplementation->distRouter->SetSearchStatisticsEnabled(enable);
+    DImplementation->timeRouter->SetSearchStatisticsEnabled(enable);
+    DImplementation->bikeRouter->SetSearchStatisticsEnabled(enable);
+}
+
+CDijkstraPathRouter::SSearchStatistics CDijkstraTransportationPlanner::SearchStatistics() const noexcept {
+    auto statistics = DImplementation->distRouter->SearchStatistics();
+    statistics += DImplementation->timeRouter->SearchStatistics();
+    statistics += DImplementation->bikeRouter->SearchStatistics();
+    return statistics;
+}
+
+void CDijkstraTransportationPlanner::ResetSearchStatistics() noexcept {
+    DImplementation->distRouter->ResetSearchStatistics();
+    DImplementation->timeRouter->ResetSearchStatistics();
+    DImplementation->bikeRouter->ResetSearchStatistics();
+}
@@ -2,6 +2,73 @@
 #include <sstream>
 #include <iomanip>
 #include <cmath>
+#include <algorithm>
+#include <array>
+
+namespace{
+    const double EarthRadiusMiles = 3959.88;
+
+    // Odd Taylor series in Horner form, |x| <= pi/2 keeps the error below
+    // 1e-15
+    inline double PolynomialSin(double x){
+        double X2 = x * x;
+        double Sum = 1.0 / 355687428096000.0;
+        Sum = Sum * X2 - 1.0 / 1307674368000.0;
+        Sum = Sum * X2 + 1.0 / 6227020800.0;
+        Sum = Sum * X2 - 1.0 / 39916800.0;
+        Sum = Sum * X2 + 1.0 / 362880.0;
+        Sum = Sum * X2 - 1.0 / 5040.0;
+        Sum = Sum * X2 + 1.0 / 120.0;
+        Sum = Sum * X2 - 1.0 / 6.0;
+        return x + x * X2 * Sum;
+    }
+
+    inline double PolynomialCos(double x){
+        double X2 = x * x;
+        double Sum = 1.0 / 6402373705728000.0;
+        Sum = Sum * X2 - 1.0 / 20922789888000.0;
+        Sum = Sum * X2 + 1.0 / 87178291200.0;
+        Sum = Sum * X2 - 1.0 / 479001600.0;
+        Sum = Sum * X2 + 1.0 / 3628800.0;
+        Sum = Sum * X2 - 1.0 / 40320.0;
+        Sum = Sum * X2 + 1.0 / 720.0;
+        Sum = Sum * X2 - 1.0 / 24.0;
+        Sum = Sum * X2 + 1.0 / 2.0;
+        return 1.0 - X2 * Sum;
+    }
+
+    // Taylor coefficients of asin, (2n)! / (4^n (n!)^2 (2n + 1))
+    constexpr std::size_t AsinTerms = 20;
+    const std::array<double, AsinTerms> AsinCoefficients = [](){
+        std::array<double, AsinTerms> Coefficients{};
+        double Central = 1.0;
+        for(std::size_t Term = 0; Term < AsinTerms; Term++){
+            Coefficients[Term] = Central / double(2 * Term + 1);
+            Central *= double(2 * Term + 1) / double(2 * Term + 2);
+        }
+        return Coefficients;
+    }();
+
+    // asin on [0, 1], above 0.5 the series runs on sqrt((1 - x) / 2) <= 0.5
+    // through asin(x) = pi/2 - 2 asin(sqrt((1 - x) / 2))
+    inline double PolynomialAsin(double x){
+        bool Reduce = x > 0.5;
+        double Y = Reduce ? std::sqrt((1.0 - x) / 2.0) : x;
+        double Y2 = Y * Y;
+        double Sum = AsinCoefficients[AsinTerms - 1];
+        for(std::size_t Term = AsinTerms - 1; Term > 0; Term--){
+            Sum = Sum * Y2 + AsinCoefficients[Term - 1];
+        }
+        double Result = Y * Sum;
+        return Reduce ? M_PI / 2 - 2.0 * Result : Result;
+    }
+
+    // Longitude difference folded into [0, pi]
+    inline double WrapLongitude(double delta){
+        delta = std::fabs(delta);
+        return delta > M_PI ? 2.0 * M_PI - delta : delta;
+    }
+}
 
 double SGeographicUtils::DegreesToRadians(double deg){
     return M_PI * (deg) / 180.0;
@@ -21,7 +88,6 @@ double SGeographicUtils::HaversineDistanceInMiles(CStreetMap::TLocation loc1, CS
     double DeltaLatSin = sin(DeltaLat/2);
     double DeltaLonSin = sin(DeltaLon/2);
     double Computation = asin(sqrt(DeltaLatSin * DeltaLatSin + cos(LatRad1) * cos(LatRad2) * DeltaLonSin * DeltaLonSin));
-    const double EarthRadiusMiles = 3959.88;
 
     return 2 * EarthRadiusMiles * Computation;
 }
@@ -97,3 +163,86 @@ std::string SGeographicUtils::ConvertLLToDMS(CStreetMap::TLocation loc){
     
     return OutStream.str();
 }
+
+uint64_t SGeographicUtils::HilbertIndex(CStreetMap::TLocation loc, CStreetMap::TLocation lower, CStreetMap::TLocation upper, unsigned order){
+    uint64_t Side = uint64_t(1) << order;
+    auto ToCell = [Side](double value, double low, double high){
+        if(!(high > low)){
+            return uint64_t(0);
+        }
+        double Scaled = (value - low) / (high - low) * double(Side);
+        return Scaled <= 0.0 ? uint64_t(0) : std::min(Side - 1, uint64_t(Scaled));
+    };
+    uint64_t X = ToCell(std::get<1>(loc),std::get<1>(lower),std::get<1>(upper));
+    uint64_t Y = ToCell(std::get<0>(loc),std::get<0>(lower),std::get<0>(upper));
+    uint64_t Index = 0;
+    for(uint64_t Half = Side / 2; Half > 0; Half /= 2){
+        uint64_t RX = (X & Half) ? 1 : 0;
+        uint64_t RY = (Y & Half) ? 1 : 0;
+        Index += Half * Half * ((3 * RX) ^ RY);
+        // Rotate the quadrant so the curve stays continuous
+        if(!RY){
+            if(RX){
+                X = Side - 1 - X;
+                Y = Side - 1 - Y;
+            }
+            std::swap(X,Y);
+        }
+    }
+    return Index;
+}
+
+void SGeographicUtils::HaversineDistancesInMiles(const CStreetMap::TLocation *src, const CStreetMap::TLocation *dest, std::size_t count, double *distances){
+    for(std::size_t Index = 0; Index < count; Index++){
+        distances[Index] = HaversineDistanceInMiles(src[Index],dest[Index]);
+    }
+}
+
+void SGeographicUtils::HaversinePolylineInMiles(const CStreetMap::TLocation *points, std::size_t count, double *distances){
+    if(count < 2){
+        return;
+    }
+    // Same operations as HaversineDistanceInMiles so results are identical,
+    // but each point's radians and cosine are computed once
+    double PrevLatRad = DegreesToRadians(std::get<0>(points[0]));
+    double PrevLonRad = DegreesToRadians(std::get<1>(points[0]));
+    double PrevLatCos = cos(PrevLatRad);
+    for(std::size_t Index = 1; Index < count; Index++){
+        double LatRad = DegreesToRadians(std::get<0>(points[Index]));
+        double LonRad = DegreesToRadians(std::get<1>(points[Index]));
+        double LatCos = cos(LatRad);
+        double DeltaLatSin = sin((LatRad - PrevLatRad)/2);
+        double DeltaLonSin = sin((LonRad - PrevLonRad)/2);
+        double Computation = asin(sqrt(DeltaLatSin * DeltaLatSin + PrevLatCos * LatCos * DeltaLonSin * DeltaLonSin));
+        distances[Index - 1] = 2 * EarthRadiusMiles * Computation;
+        PrevLatRad = LatRad;
+        PrevLonRad = LonRad;
+        PrevLatCos = LatCos;
+    }
+}
+
+void SGeographicUtils::FastHaversineDistancesInMiles(const CStreetMap::TLocation *src, const CStreetMap::TLocation *dest, std::size_t count, double *distances){
+    const double Radians = M_PI / 180.0;
+    for(std::size_t Index = 0; Index < count; Index++){
+        double LatRad1 = src[Index].first * Radians;
+        double LatRad2 = dest[Index].first * Radians;
+        double HalfDeltaLat = (LatRad2 - LatRad1) / 2;
+        // sin^2 is symmetric about pi/2, fold the half angle into range
+        double HalfDeltaLon = WrapLongitude((dest[Index].second - src[Index].second) * Radians) / 2;
+        double DeltaLatSin = PolynomialSin(HalfDeltaLat);
+        double DeltaLonSin = PolynomialSin(HalfDeltaLon);
+        double Haversine = DeltaLatSin * DeltaLatSin + PolynomialCos(LatRad1) * PolynomialCos(LatRad2) * DeltaLonSin * DeltaLonSin;
+        Haversine = std::min(1.0,std::max(0.0,Haversine));
+        distances[Index] = 2 * EarthRadiusMiles * PolynomialAsin(std::sqrt(Haversine));
+    }
+}
+
+void SGeographicUtils::EquirectangularDistancesInMiles(const CStreetMap::TLocation *src, const CStreetMap::TLocation *dest, std::size_t count, double *distances){
+    const double Radians = M_PI / 180.0;
+    for(std::size_t Index = 0; Index < count; Index++){
+        double DeltaLat = (dest[Index].first - src[Index].first) * Radians;
+        double MeanLat = (dest[Index].first + src[Index].first) * (Radians / 2);
+        double DeltaLon = WrapLongitude((dest[Index].second - src[Index].second) * Radians) * PolynomialCos(MeanLat);
+        distances[Index] = EarthRadiusMiles * std::sqrt(DeltaLat * DeltaLat + DeltaLon * DeltaLon);
+    }
+}
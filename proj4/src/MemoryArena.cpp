@@ -0,0 +1,44 @@
+#include "MemoryArena.h"
+
+void *CMemoryArena::CUpstream::do_allocate(std::size_t bytes, std::size_t alignment){
+    DBytes += bytes;
+    DBlocks++;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void CMemoryArena::CUpstream::do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment){
+    std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+}
+
+bool CMemoryArena::CUpstream::do_is_equal(const std::pmr::memory_resource &other) const noexcept{
+    return this == &other;
+}
+
+CMemoryArena::CMemoryArena(std::size_t initialsize) : DResource(initialsize, &DUpstream){
+
+}
+
+void *CMemoryArena::do_allocate(std::size_t bytes, std::size_t alignment){
+    DAllocatedBytes += bytes;
+    return DResource.allocate(bytes, alignment);
+}
+
+void CMemoryArena::do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment){
+    // Released with the arena
+}
+
+bool CMemoryArena::do_is_equal(const std::pmr::memory_resource &other) const noexcept{
+    return this == &other;
+}
+
+std::size_t CMemoryArena::AllocatedBytes() const noexcept{
+    return DAllocatedBytes;
+}
+
+std::size_t CMemoryArena::ReservedBytes() const noexcept{
+    return DUpstream.DBytes;
+}
+
+std::size_t CMemoryArena::BlockCount() const noexcept{
+    return DUpstream.DBlocks;
+}
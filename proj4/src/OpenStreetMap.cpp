@@ -1,18 +1,57 @@
 #include "OpenStreetMap.h"    // includ the openstreetmap header  
 #include "XMLReader.h"        // includ the xml reader header for parsing xml  
+#include "MemoryArena.h"      // includ the arena that holds every node and way  
 #include <memory>             // includ memory for smart pointers like shared_ptr and unique_ptr  
 #include <vector>             // includ vector for dynamic arrays  
 #include <string>             // includ string for handeling text  
-#include <unordered_map>      // includ unordered_map for attribute lookups  
-#include <iterator>           // includ iterator for std advance  
+#include <memory_resource>    // includ memory_resource for the arena backed containers  
+#include <string_view>        // includ string_view for copying tags into the arena  
+#include <chrono>             // includ chrono for the load phase timers  
+#include <algorithm>          // includ algorithm for std min and lower bound  
 
 // this struct hold the internl impl for openstreetmap it also forward declares our internl node and way classes  
 struct COpenStreetMap::SImplementation {
     class SNodeImpl;  // forward declare our node impl  
     class SWayImpl;   // forward declare our way impl  
+    // tags are kept as key value pairs in document order  
+    using TAttributeList = std::pmr::vector<std::pair<std::pmr::string, std::pmr::string>>;
+    // every node and way lives in the arena so loading takes a few big blocks and teardown just frees them  
+    // the pointers we hand out share ownership of the arena so they stay valid after the map is gone  
+    std::shared_ptr<CMemoryArena> arena = std::make_shared<CMemoryArena>();
     // these vectors store our nodes and ways respectivly  note the double  space in this comment  
-    std::vector<std::shared_ptr<SNodeImpl>> nodes_collection;
-    std::vector<std::shared_ptr<SWayImpl>> ways_collection;
+    std::vector<SNodeImpl *> nodes_collection;
+    std::vector<SWayImpl *> ways_collection;
+    // ids in osm extracts are normally ascending so lookups by id can binary search  
+    bool nodes_sorted = true;
+    bool ways_sorted = true;
+    // time spent reading xml entities and building objects while loading  
+    std::chrono::nanoseconds parse_time{0};
+    std::chrono::nanoseconds build_time{0};
+
+    // finds a tag by key or returns the end of the list  
+    static TAttributeList::const_iterator find_attribute(const TAttributeList &attr_list, const std::string &key) {
+        for (auto it = attr_list.begin(); it != attr_list.end(); ++it) {
+            if (it->first.compare(key) == 0) {
+                return it;
+            }
+        }
+        return attr_list.end();
+    }
+
+    // finds a node or way by id with a binary search when the ids are ascending and a scan otherwise  
+    template <typename TElement>
+    static TElement *find_by_id(const std::vector<TElement *> &collection, bool sorted, uint64_t id) {
+        if (sorted) {
+            auto it = std::lower_bound(collection.begin(), collection.end(), id,
+                                       [](const TElement *element, uint64_t value) { return element->ID() < value; });
+            return it != collection.end() && (*it)->ID() == id ? *it : nullptr;
+        }
+        for (auto element : collection) {
+            if (element->ID() == id)
+                return element;
+        }
+        return nullptr;
+    }
 };
 
 // this is our internl node impl which inherits from cstreetmap s node class  
@@ -20,7 +59,9 @@ class COpenStreetMap::SImplementation::SNodeImpl : public CStreetMap::SNode {
 public:
     TNodeID node_identifier;  // uniq id for the node  
     TLocation coordinates;    // the lat and lon of the node  
-    std::unordered_map<std::string, std::string> attr_map;  // a map for node attributes  
+    TAttributeList attr_list;  // the node attributes allocated in the arena  
+
+    explicit SNodeImpl(std::pmr::memory_resource *arena) : attr_list(arena) {}
 
     // returns the node id dont use any punctuation in these comments  note the double  space  
     TNodeID ID() const noexcept override {
@@ -34,29 +75,27 @@ public:
 
     // returns the number of attributes this node has  
     std::size_t AttributeCount() const noexcept override {
-        return attr_map.size();
+        return attr_list.size();
     }
 
     // returns the key of the attribute at the given pos or empty string if pos is out of bounds  
     std::string GetAttributeKey(std::size_t pos) const noexcept override {
-        if (pos < attr_map.size()) {
-            auto it = attr_map.begin();
-            std::advance(it, pos);
-            return it->first;
+        if (pos < attr_list.size()) {
+            return std::string(attr_list[pos].first);
         }
         return "";
     }
 
     // checks if the node has an attribute with the given key  
     bool HasAttribute(const std::string &key) const noexcept override {
-        return attr_map.find(key) != attr_map.end();
+        return find_attribute(attr_list, key) != attr_list.end();
     }
 
     // returns the attribute value for a given key or empty string if not found  
     std::string GetAttribute(const std::string &key) const noexcept override {
-        auto it = attr_map.find(key);
-        if (it != attr_map.end()) {
-            return it->second;
+        auto it = find_attribute(attr_list, key);
+        if (it != attr_list.end()) {
+            return std::string(it->second);
         }
         return "";
     }
@@ -66,8 +105,10 @@ public:
 class COpenStreetMap::SImplementation::SWayImpl : public CStreetMap::SWay {
 public:
     TWayID way_identifier;  // uniq id for the way  
-    std::vector<TNodeID> node_refs;  // list of node ids that define this way  
-    std::unordered_map<std::string, std::string> attr_map;  // a map for way attributes  
+    std::pmr::vector<TNodeID> node_refs;  // list of node ids that define this way  
+    TAttributeList attr_list;  // the way attributes allocated in the arena  
+
+    explicit SWayImpl(std::pmr::memory_resource *arena) : node_refs(arena), attr_list(arena) {}
 
     // returns the way id  
     TWayID ID() const noexcept override {
@@ -89,29 +130,27 @@ public:
 
     // returns the number of attributes for this way  
     std::size_t AttributeCount() const noexcept override {
-        return attr_map.size();
+        return attr_list.size();
     }
 
     // returns the key of the attribute at the given pos or empty string if out of bounds  
     std::string GetAttributeKey(std::size_t pos) const noexcept override {
-        if (pos < attr_map.size()) {
-            auto it = attr_map.begin();
-            std::advance(it, pos);
-            return it->first;
+        if (pos < attr_list.size()) {
+            return std::string(attr_list[pos].first);
         }
         return "";
     }
 
     // checks if the way has an attribute with the given key  
     bool HasAttribute(const std::string &key) const noexcept override {
-        return attr_map.find(key) != attr_map.end();
+        return find_attribute(attr_list, key) != attr_list.end();
     }
 
     // returns the value for a given attribute key or empty if not found  
     std::string GetAttribute(const std::string &key) const noexcept override {
-        auto it = attr_map.find(key);
-        if (it != attr_map.end()) {
-            return it->second;
+        auto it = find_attribute(attr_list, key);
+        if (it != attr_list.end()) {
+            return std::string(it->second);
         }
         return "";
     }
@@ -120,80 +159,129 @@ public:
 // the constructor reads through the xml file and builds our nodes and ways it dosent use any extra punctuation  
 COpenStreetMap::COpenStreetMap(std::shared_ptr<CXMLReader> src) {
     DImplementation = std::make_unique<SImplementation>();
+    CMemoryArena &arena = *DImplementation->arena;
 
     SXMLEntity xml_entity;
-    // pointers to track the current node or way being processed note the double  space here  
-    std::shared_ptr<SImplementation::SNodeImpl> cur_node = nullptr;
-    std::shared_ptr<SImplementation::SWayImpl> cur_way = nullptr;
+    // the element being read is collected here and copied into the arena once it ends  
+    // that way nothing in the arena is ever regrown and left behind  
+    enum class element_kind { none, node, way };
+    element_kind cur_kind = element_kind::none;
+    TNodeID cur_id = 0;
+    TLocation cur_location{0.0, 0.0};
+    std::vector<TNodeID> cur_refs;
+    std::vector<std::pair<std::string, std::string>> cur_attrs;
+
+    // a repeated key keeps the last value like the old attribute map did  
+    auto set_attribute = [&](const std::string &key, const std::string &value) {
+        for (auto &attribute : cur_attrs) {
+            if (attribute.first == key) {
+                attribute.second = value;
+                return;
+            }
+        }
+        cur_attrs.emplace_back(key, value);
+    };
+    auto copy_attributes = [&](SImplementation::TAttributeList &attr_list) {
+        attr_list.reserve(cur_attrs.size());
+        for (const auto &attribute : cur_attrs) {
+            attr_list.emplace_back(std::string_view(attribute.first), std::string_view(attribute.second));
+        }
+    };
+    auto start_element = [&](element_kind kind) {
+        cur_kind = kind;
+        cur_id = 0;
+        cur_location = {0.0, 0.0};
+        cur_refs.clear();
+        cur_attrs.clear();
+    };
+
+    // the reader is timed on its own and everything else counts as build  
+    using clock = std::chrono::steady_clock;
+    auto load_start = clock::now();
+    auto read_entity = [&]() {
+        auto read_start = clock::now();
+        bool read = src->ReadEntity(xml_entity);
+        DImplementation->parse_time += clock::now() - read_start;
+        return read;
+    };
 
     // process each entity in the xml document  
-    while (src->ReadEntity(xml_entity)) {
+    while (read_entity()) {
         if (xml_entity.DType == SXMLEntity::EType::StartElement) {
             if (xml_entity.DNameData == "node") {
-                cur_node = std::make_shared<SImplementation::SNodeImpl>();
-                cur_way = nullptr;  // reset the way pointer  
+                start_element(element_kind::node);
                 // process each attribute for this node element  
                 for (const auto &attribute : xml_entity.DAttributes) {
                     const std::string &attr_name = attribute.first;
                     const std::string &attr_value = attribute.second;
                     if (attr_name == "id") {
-                        cur_node->node_identifier = std::stoull(attr_value);
+                        cur_id = std::stoull(attr_value);
                     } else if (attr_name == "lat") {
-                        cur_node->coordinates.first = std::stod(attr_value);
+                        cur_location.first = std::stod(attr_value);
                     } else if (attr_name == "lon") {
-                        cur_node->coordinates.second = std::stod(attr_value);
+                        cur_location.second = std::stod(attr_value);
                     } else {
-                        cur_node->attr_map[attr_name] = attr_value;
+                        set_attribute(attr_name, attr_value);
                     }
                 }
             } else if (xml_entity.DNameData == "way") {
-                cur_way = std::make_shared<SImplementation::SWayImpl>();
-                cur_node = nullptr;  // reset the node pointer  
+                start_element(element_kind::way);
                 // process each attribute for this way element  
                 for (const auto &attribute : xml_entity.DAttributes) {
                     if (attribute.first == "id") {
-                        cur_way->way_identifier = std::stoull(attribute.second);
+                        cur_id = std::stoull(attribute.second);
                     } else {
-                        cur_way->attr_map[attribute.first] = attribute.second;
+                        set_attribute(attribute.first, attribute.second);
                     }
                 }
-            } else if (xml_entity.DNameData == "nd" && cur_way) {
+            } else if (xml_entity.DNameData == "nd" && cur_kind == element_kind::way) {
                 // add node reference to the current way  
                 for (const auto &attribute : xml_entity.DAttributes) {
                     if (attribute.first == "ref") {
-                        cur_way->node_refs.push_back(std::stoull(attribute.second));
+                        cur_refs.push_back(std::stoull(attribute.second));
                     }
                 }
             } else if (xml_entity.DNameData == "tag") {
                 // process a tag element this works for both nodes and ways  
-                std::string key, value;
+                const std::string *key = nullptr, *value = nullptr;
                 for (const auto &attribute : xml_entity.DAttributes) {
                     if (attribute.first == "k") {
-                        key = attribute.second;
+                        key = &attribute.second;
                     } else if (attribute.first == "v") {
-                        value = attribute.second;
+                        value = &attribute.second;
                     }
                 }
-                if (!key.empty()) {
-                    if (cur_node) {
-                        cur_node->attr_map[key] = value;
-                    } else if (cur_way) {
-                        cur_way->attr_map[key] = value;
-                    }
+                if (key && !key->empty() && cur_kind != element_kind::none) {
+                    set_attribute(*key, value ? *value : std::string());
                 }
             }
         } else if (xml_entity.DType == SXMLEntity::EType::EndElement) {
-            if (xml_entity.DNameData == "node" && cur_node) {
+            if (xml_entity.DNameData == "node" && cur_kind == element_kind::node) {
                 // finish processing the node and store it  
-                DImplementation->nodes_collection.push_back(cur_node);
-                cur_node = nullptr;
-            } else if (xml_entity.DNameData == "way" && cur_way) {
+                auto node = arena.Create<SImplementation::SNodeImpl>(&arena);
+                node->node_identifier = cur_id;
+                node->coordinates = cur_location;
+                copy_attributes(node->attr_list);
+                auto &nodes = DImplementation->nodes_collection;
+                if (!nodes.empty() && nodes.back()->node_identifier > cur_id)
+                    DImplementation->nodes_sorted = false;
+                nodes.push_back(node);
+                cur_kind = element_kind::none;
+            } else if (xml_entity.DNameData == "way" && cur_kind == element_kind::way) {
                 // finish processing the way and store it  
-                DImplementation->ways_collection.push_back(cur_way);
-                cur_way = nullptr;
+                auto way = arena.Create<SImplementation::SWayImpl>(&arena);
+                way->way_identifier = cur_id;
+                way->node_refs.assign(cur_refs.begin(), cur_refs.end());
+                copy_attributes(way->attr_list);
+                auto &ways = DImplementation->ways_collection;
+                if (!ways.empty() && ways.back()->way_identifier > cur_id)
+                    DImplementation->ways_sorted = false;
+                ways.push_back(way);
+                cur_kind = element_kind::none;
             }
         }
     }
+    DImplementation->build_time = clock::now() - load_start - DImplementation->parse_time;
 }
 
 COpenStreetMap::~COpenStreetMap() = default;
@@ -209,23 +297,19 @@ std::size_t COpenStreetMap::WayCount() const noexcept {
 }
 
 // returns a node at the given index or null if the index is out of bounds  
-std::shared_ptr<CStreetMap::SNode> COpenStreetMap::NodeByIndex(std::size_t idx) const noexcept {
+const CStreetMap::SNode *COpenStreetMap::NodePtrByIndex(std::size_t idx) const noexcept {
     if (idx < DImplementation->nodes_collection.size())
         return DImplementation->nodes_collection[idx];
     return nullptr;
 }
 
 // returns a node that matches the given id or null if not found  
-std::shared_ptr<CStreetMap::SNode> COpenStreetMap::NodeByID(TNodeID id) const noexcept {
-    for (const auto &node : DImplementation->nodes_collection) {
-        if (node->ID() == id)
-            return node;
-    }
-    return nullptr;
+const CStreetMap::SNode *COpenStreetMap::NodePtrByID(TNodeID id) const noexcept {
+    return SImplementation::find_by_id(DImplementation->nodes_collection, DImplementation->nodes_sorted, id);
 }
 
 // returns a way at the given index or null if the index is too high  
-std::shared_ptr<CStreetMap::SWay> COpenStreetMap::WayByIndex(std::size_t idx) const noexcept {
+const CStreetMap::SWay *COpenStreetMap::WayPtrByIndex(std::size_t idx) const noexcept {
     if (idx < DImplementation->ways_collection.size())
         return DImplementation->ways_collection[idx];
     else {
@@ -234,11 +318,78 @@ std::shared_ptr<CStreetMap::SWay> COpenStreetMap::WayByIndex(std::size_t idx) co
 }
 
 // returns a way that matches the given id or null if not found  
-std::shared_ptr<CStreetMap::SWay> COpenStreetMap::WayByID(TWayID id) const noexcept {
-    auto currId = id;
-    for (const auto &way : DImplementation->ways_collection) {
-        if (way->ID() == currId)
-            return way;
+const CStreetMap::SWay *COpenStreetMap::WayPtrByID(TWayID id) const noexcept {
+    return SImplementation::find_by_id(DImplementation->ways_collection, DImplementation->ways_sorted, id);
+}
+
+// the shared versions alias the arena so the object keeps it alive  
+std::shared_ptr<CStreetMap::SNode> COpenStreetMap::NodeByIndex(std::size_t idx) const noexcept {
+    if (idx < DImplementation->nodes_collection.size())
+        return std::shared_ptr<CStreetMap::SNode>(DImplementation->arena, DImplementation->nodes_collection[idx]);
+    return nullptr;
+}
+
+std::shared_ptr<CStreetMap::SNode> COpenStreetMap::NodeByID(TNodeID id) const noexcept {
+    auto node = SImplementation::find_by_id(DImplementation->nodes_collection, DImplementation->nodes_sorted, id);
+    if (node)
+        return std::shared_ptr<CStreetMap::SNode>(DImplementation->arena, node);
+    return nullptr;
+}
+
+std::shared_ptr<CStreetMap::SWay> COpenStreetMap::WayByIndex(std::size_t idx) const noexcept {
+    if (idx < DImplementation->ways_collection.size())
+        return std::shared_ptr<CStreetMap::SWay>(DImplementation->arena, DImplementation->ways_collection[idx]);
+    else {
+        return nullptr;
     }
+}
+
+std::shared_ptr<CStreetMap::SWay> COpenStreetMap::WayByID(TWayID id) const noexcept {
+    auto way = SImplementation::find_by_id(DImplementation->ways_collection, DImplementation->ways_sorted, id);
+    if (way)
+        return std::shared_ptr<CStreetMap::SWay>(DImplementation->arena, way);
     return nullptr;
 }
+
+// adds the attribute list of a node or way to the tag totals  
+template <typename TAttributeList>
+static void count_tags(const TAttributeList &attr_list, std::size_t &count, std::size_t &bytes) {
+    count += attr_list.size();
+    bytes += SConstructionReport::VectorBytes(attr_list);
+    for (const auto &attribute : attr_list) {
+        bytes += SConstructionReport::StringBytes(attribute.first) + SConstructionReport::StringBytes(attribute.second);
+    }
+}
+
+// reports the load phases and the memory held by nodes ways and their tags  
+bool COpenStreetMap::ConstructionReport(SConstructionReport &report) const noexcept {
+    report = SConstructionReport();
+    report.DName = "COpenStreetMap";
+    report.AddPhase("xml parse", DImplementation->parse_time);
+    report.AddPhase("object build", DImplementation->build_time);
+
+    const auto &nodes = DImplementation->nodes_collection;
+    const auto &ways = DImplementation->ways_collection;
+    std::size_t node_tags = 0, node_tag_bytes = 0;
+    for (const auto &node : nodes) {
+        count_tags(node->attr_list, node_tags, node_tag_bytes);
+    }
+    std::size_t way_refs = 0, way_ref_bytes = 0, way_tags = 0, way_tag_bytes = 0;
+    for (const auto &way : ways) {
+        way_refs += way->node_refs.size();
+        way_ref_bytes += SConstructionReport::VectorBytes(way->node_refs);
+        count_tags(way->attr_list, way_tags, way_tag_bytes);
+    }
+    report.AddComponent("nodes", nodes.size(), SConstructionReport::VectorBytes(nodes) +
+                        nodes.size() * sizeof(SImplementation::SNodeImpl));
+    report.AddComponent("node tags", node_tags, node_tag_bytes);
+    report.AddComponent("ways", ways.size(), SConstructionReport::VectorBytes(ways) +
+                        ways.size() * sizeof(SImplementation::SWayImpl));
+    report.AddComponent("way node refs", way_refs, way_ref_bytes);
+    report.AddComponent("way tags", way_tags, way_tag_bytes);
+    // arena blocks not yet handed out plus padding between objects  
+    const auto &arena = *DImplementation->arena;
+    report.AddComponent("arena slack", arena.BlockCount(), arena.ReservedBytes() - std::min(arena.AllocatedBytes(), arena.ReservedBytes()));
+    return true;
+}
+
@@ -0,0 +1,179 @@
+#include "PathCache.h"
+#include "CompactPath.h"
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+struct CPathCache::SImplementation{
+    struct SKey{
+        TNodeID DSource;
+        TNodeID DDestination;
+        EMetric DMetric;
+
+        bool operator==(const SKey &other) const noexcept{
+            return DSource == other.DSource && DDestination == other.DDestination && DMetric == other.DMetric;
+        }
+    };
+
+    struct SKeyHash{
+        std::size_t operator()(const SKey &key) const noexcept{
+            std::size_t Hash = std::hash<TNodeID>()(key.DSource);
+            Hash ^= std::hash<TNodeID>()(key.DDestination) * 0x9E3779B97F4A7C15ULL;
+            return Hash ^ (static_cast<std::size_t>(key.DMetric) << 1);
+        }
+    };
+
+    struct SEntry{
+        SKey DKey;
+        double DCost;
+        std::vector<std::uint8_t> DPath;
+    };
+
+    using TEntryList = std::list<SEntry>;
+
+    std::size_t DCapacity;
+    std::uint64_t DGeneration = 0;
+    // Most recently used entries are kept at the front of the list
+    TEntryList DEntries;
+    std::unordered_map<SKey, TEntryList::iterator, SKeyHash> DLookup;
+    SStatistics DStatistics;
+    mutable std::mutex DMutex;
+
+    SImplementation(std::size_t capacity) : DCapacity(capacity){
+        DLookup.reserve(capacity);
+    }
+
+    void ClearEntries(){
+        DEntries.clear();
+        DLookup.clear();
+        DStatistics.DEntries = 0;
+        DStatistics.DCompressedBytes = 0;
+    }
+
+    void CheckGeneration(std::uint64_t generation){
+        if(generation != DGeneration){
+            if(!DEntries.empty()){
+                DStatistics.DInvalidations++;
+            }
+            ClearEntries();
+            DGeneration = generation;
+        }
+    }
+};
+
+CPathCache::CPathCache(std::size_t capacity){
+    DImplementation = std::make_unique<SImplementation>(capacity);
+}
+
+CPathCache::~CPathCache(){
+
+}
+
+std::size_t CPathCache::Capacity() const noexcept{
+    return DImplementation->DCapacity;
+}
+
+CPathCache::SStatistics CPathCache::Statistics() const noexcept{
+    std::lock_guard<std::mutex> Lock(DImplementation->DMutex);
+    return DImplementation->DStatistics;
+}
+
+void CPathCache::Clear() noexcept{
+    std::lock_guard<std::mutex> Lock(DImplementation->DMutex);
+    DImplementation->ClearEntries();
+}
+
+bool CPathCache::Lookup(TNodeID src, TNodeID dest, EMetric metric, std::uint64_t generation, double &cost, std::vector<TTripStep> &path) noexcept{
+    std::lock_guard<std::mutex> Lock(DImplementation->DMutex);
+    DImplementation->CheckGeneration(generation);
+    auto Search = DImplementation->DLookup.find({src,dest,metric});
+    if(Search == DImplementation->DLookup.end()){
+        DImplementation->DStatistics.DMisses++;
+        return false;
+    }
+    auto Entry = Search->second;
+    DImplementation->DEntries.splice(DImplementation->DEntries.begin(),DImplementation->DEntries,Entry);
+    if(!DecodePath(Entry->DPath,path)){
+        DImplementation->DStatistics.DMisses++;
+        return false;
+    }
+    cost = Entry->DCost;
+    DImplementation->DStatistics.DHits++;
+    return true;
+}
+
+void CPathCache::Insert(TNodeID src, TNodeID dest, EMetric metric, std::uint64_t generation, double cost, const std::vector<TTripStep> &path) noexcept{
+    if(!DImplementation->DCapacity){
+        return;
+    }
+    std::vector<std::uint8_t> Encoded;
+    EncodePath(path,Encoded);
+    std::lock_guard<std::mutex> Lock(DImplementation->DMutex);
+    DImplementation->CheckGeneration(generation);
+    auto &Statistics = DImplementation->DStatistics;
+    SImplementation::SKey Key{src,dest,metric};
+    auto Search = DImplementation->DLookup.find(Key);
+    if(Search != DImplementation->DLookup.end()){
+        auto Entry = Search->second;
+        Statistics.DCompressedBytes -= Entry->DPath.size();
+        Entry->DCost = cost;
+        Entry->DPath.swap(Encoded);
+        Statistics.DCompressedBytes += Entry->DPath.size();
+        DImplementation->DEntries.splice(DImplementation->DEntries.begin(),DImplementation->DEntries,Entry);
+        return;
+    }
+    if(DImplementation->DEntries.size() >= DImplementation->DCapacity){
+        auto &Oldest = DImplementation->DEntries.back();
+        Statistics.DCompressedBytes -= Oldest.DPath.size();
+        DImplementation->DLookup.erase(Oldest.DKey);
+        DImplementation->DEntries.pop_back();
+        Statistics.DEvictions++;
+    }
+    Statistics.DCompressedBytes += Encoded.size();
+    DImplementation->DEntries.push_front({Key,cost,std::move(Encoded)});
+    DImplementation->DLookup[Key] = DImplementation->DEntries.begin();
+    Statistics.DEntries = DImplementation->DEntries.size();
+}
+
+// Steps are grouped into runs of the same mode, each run is a varint of
+// (length << 2 | mode) followed by one zigzag varint per node holding the
+// delta from the previous node ID.
+void CPathCache::EncodePath(const std::vector<TTripStep> &path, std::vector<std::uint8_t> &encoded){
+    encoded.clear();
+    TNodeID Previous = 0;
+    std::size_t RunStart = 0;
+    while(RunStart < path.size()){
+        std::size_t RunEnd = RunStart + 1;
+        while(RunEnd < path.size() && path[RunEnd].first == path[RunStart].first){
+            RunEnd++;
+        }
+        CCompactPath::WriteVarint((static_cast<std::uint64_t>(RunEnd - RunStart) << 2) | static_cast<std::uint64_t>(path[RunStart].first),encoded);
+        for(std::size_t Index = RunStart; Index < RunEnd; Index++){
+            CCompactPath::WriteDelta(Previous,path[Index].second,encoded);
+            Previous = path[Index].second;
+        }
+        RunStart = RunEnd;
+    }
+}
+
+bool CPathCache::DecodePath(const std::vector<std::uint8_t> &encoded, std::vector<TTripStep> &path){
+    path.clear();
+    TNodeID Previous = 0;
+    std::size_t Index = 0;
+    while(Index < encoded.size()){
+        std::uint64_t Header;
+        if(!CCompactPath::ReadVarint(encoded,Index,Header)){
+            path.clear();
+            return false;
+        }
+        auto Mode = static_cast<CTransportationPlanner::ETransportationMode>(Header & 0x3);
+        for(std::uint64_t Count = Header >> 2; Count; Count--){
+            if(!CCompactPath::ReadDelta(encoded,Index,Previous)){
+                path.clear();
+                return false;
+            }
+            path.push_back({Mode,Previous});
+        }
+    }
+    return true;
+}
@@ -0,0 +1,55 @@
+#include "RoutingProfile.h"
+
+double SRoutingWay::ParseSpeedLimit(const std::string &maxspeed, double defaultspeed){
+    // Leading number of values like "25 mph", anything else keeps the default
+    std::size_t Length = 0;
+    while(Length < maxspeed.size() && ((maxspeed[Length] >= '0' && maxspeed[Length] <= '9') || maxspeed[Length] == '.')){
+        Length++;
+    }
+    if(!Length){
+        return defaultspeed;
+    }
+    try{
+        double Speed = std::stod(maxspeed.substr(0,Length));
+        return Speed > 0.0 ? Speed : defaultspeed;
+    }
+    catch(...){
+        return defaultspeed;
+    }
+}
+
+SRoutingWay SRoutingWay::FromWay(const CStreetMap::SWay &way, double defaultspeed){
+    SRoutingWay Result{defaultspeed, 0};
+    if(way.HasAttribute("maxspeed")){
+        Result.DSpeedLimit = ParseSpeedLimit(way.GetAttribute("maxspeed"),defaultspeed);
+    }
+    if(way.HasAttribute("oneway")){
+        std::string Value = way.GetAttribute("oneway");
+        if(Value == "yes" || Value == "true" || Value == "1"){
+            Result.DFlags |= Oneway;
+        }
+    }
+    std::string Highway = way.GetAttribute("highway");
+    if(Highway == "motorway" || Highway == "motorway_link"){
+        Result.DFlags |= Motorway;
+    }
+    else if(Highway == "steps"){
+        Result.DFlags |= Steps;
+    }
+    else if(Highway == "footway" || Highway == "path" || Highway == "pedestrian"){
+        Result.DFlags |= FootOnly;
+    }
+    if(way.GetAttribute("foot") == "no"){
+        Result.DFlags |= NoFoot;
+    }
+    if(way.GetAttribute("bicycle") == "no"){
+        Result.DFlags |= NoBicycle;
+    }
+    if(way.GetAttribute("wheelchair") == "no"){
+        Result.DFlags |= NoWheelchair;
+    }
+    if(way.GetAttribute("motor_vehicle") == "no"){
+        Result.DFlags |= NoMotor;
+    }
+    return Result;
+}
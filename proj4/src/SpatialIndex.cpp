@@ -0,0 +1,358 @@
+#include "SpatialIndex.h"
+#include "GeographicUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+
+namespace{
+    struct SBox{
+        double DMinLat;
+        double DMinLon;
+        double DMaxLat;
+        double DMaxLon;
+
+        static SBox Around(const CStreetMap::TLocation &start, const CStreetMap::TLocation &end){
+            return {std::min(start.first,end.first),std::min(start.second,end.second),
+                    std::max(start.first,end.first),std::max(start.second,end.second)};
+        }
+        void Expand(const SBox &box){
+            DMinLat = std::min(DMinLat,box.DMinLat);
+            DMinLon = std::min(DMinLon,box.DMinLon);
+            DMaxLat = std::max(DMaxLat,box.DMaxLat);
+            DMaxLon = std::max(DMaxLon,box.DMaxLon);
+        }
+        double CenterLat() const{
+            return (DMinLat + DMaxLat) / 2.0;
+        }
+        double CenterLon() const{
+            return (DMinLon + DMaxLon) / 2.0;
+        }
+    };
+
+    // Packed R-tree shared by the node and segment indices. Children of a
+    // tree node are the contiguous range DBegin to DEnd of either the
+    // entries (leaves) or DTreeNodes, the root is the last node.
+    class CPackedTree{
+        public:
+            static constexpr std::size_t NodeCapacity = 16;
+
+        private:
+            struct STreeNode{
+                SBox DBox;
+                std::size_t DBegin;
+                std::size_t DEnd;
+                bool DLeaf;
+            };
+
+            std::vector<STreeNode> DTreeNodes;
+
+            // Sort tile recursive order: vertical slices by longitude, each
+            // slice sorted by latitude
+            static std::vector<std::size_t> TileOrder(const std::vector<SBox> &boxes){
+                std::vector<std::size_t> Order(boxes.size());
+                for(std::size_t Index = 0; Index < Order.size(); Index++){
+                    Order[Index] = Index;
+                }
+                std::size_t PageCount = (boxes.size() + NodeCapacity - 1) / NodeCapacity;
+                std::size_t SliceCount = std::max<std::size_t>(1,std::ceil(std::sqrt(double(PageCount))));
+                std::size_t SliceSize = SliceCount * NodeCapacity;
+                std::sort(Order.begin(),Order.end(),[&](std::size_t a, std::size_t b){
+                    return boxes[a].CenterLon() < boxes[b].CenterLon();
+                });
+                for(std::size_t Begin = 0; Begin < Order.size(); Begin += SliceSize){
+                    auto End = Order.begin() + std::min(Begin + SliceSize,Order.size());
+                    std::sort(Order.begin() + Begin,End,[&](std::size_t a, std::size_t b){
+                        return boxes[a].CenterLat() < boxes[b].CenterLat();
+                    });
+                }
+                return Order;
+            }
+
+            // Lower bound on the Haversine distance from loc to any point in
+            // box. The latitude and longitude terms of the haversine are
+            // bounded separately, cos(lat) over the box is smallest at one of
+            // its edges.
+            static double MinimumDistance(const CStreetMap::TLocation &loc, const SBox &box){
+                const double EarthRadiusMiles = 3959.88;
+                double DeltaLat = 0.0;
+                if(loc.first < box.DMinLat){
+                    DeltaLat = box.DMinLat - loc.first;
+                }
+                else if(loc.first > box.DMaxLat){
+                    DeltaLat = loc.first - box.DMaxLat;
+                }
+                double DeltaLon = 0.0;
+                if(loc.second < box.DMinLon){
+                    DeltaLon = box.DMinLon - loc.second;
+                }
+                else if(loc.second > box.DMaxLon){
+                    DeltaLon = loc.second - box.DMaxLon;
+                }
+                if(DeltaLat == 0.0 && DeltaLon == 0.0){
+                    return 0.0;
+                }
+                DeltaLon = std::min(DeltaLon,180.0);
+                double DeltaLatSin = std::sin(SGeographicUtils::DegreesToRadians(DeltaLat) / 2);
+                double DeltaLonSin = std::sin(SGeographicUtils::DegreesToRadians(DeltaLon) / 2);
+                double MinCos = std::min(std::cos(SGeographicUtils::DegreesToRadians(box.DMinLat)),std::cos(SGeographicUtils::DegreesToRadians(box.DMaxLat)));
+                double Haversine = DeltaLatSin * DeltaLatSin + std::cos(SGeographicUtils::DegreesToRadians(loc.first)) * std::max(0.0,MinCos) * DeltaLonSin * DeltaLonSin;
+                // Slack so rounding never lets the bound exceed a true distance
+                return 2 * EarthRadiusMiles * std::asin(std::sqrt(std::min(1.0,Haversine))) * (1.0 - 1e-9);
+            }
+
+        public:
+            std::size_t MemoryUsage() const noexcept{
+                return DTreeNodes.capacity() * sizeof(STreeNode);
+            }
+
+            // Builds the tree over the entry boxes and returns the order the
+            // caller must store its entries in
+            std::vector<std::size_t> Build(std::vector<SBox> boxes){
+                DTreeNodes.clear();
+                std::vector<std::size_t> EntryOrder = TileOrder(boxes);
+                std::size_t LevelBegin = 0;
+                for(std::size_t Begin = 0; Begin < EntryOrder.size(); Begin += NodeCapacity){
+                    std::size_t End = std::min(Begin + NodeCapacity,EntryOrder.size());
+                    SBox Box = boxes[EntryOrder[Begin]];
+                    for(std::size_t Index = Begin + 1; Index < End; Index++){
+                        Box.Expand(boxes[EntryOrder[Index]]);
+                    }
+                    DTreeNodes.push_back({Box,Begin,End,true});
+                }
+                // Pack each level into parents until one node remains
+                while(DTreeNodes.size() - LevelBegin > 1){
+                    std::vector<STreeNode> Level(DTreeNodes.begin() + LevelBegin,DTreeNodes.end());
+                    DTreeNodes.resize(LevelBegin);
+                    boxes.clear();
+                    for(auto &Node : Level){
+                        boxes.push_back(Node.DBox);
+                    }
+                    for(auto Index : TileOrder(boxes)){
+                        DTreeNodes.push_back(Level[Index]);
+                    }
+                    std::size_t ChildBegin = LevelBegin;
+                    LevelBegin = DTreeNodes.size();
+                    for(std::size_t Begin = ChildBegin; Begin < LevelBegin; Begin += NodeCapacity){
+                        std::size_t End = std::min(Begin + NodeCapacity,LevelBegin);
+                        SBox Box = DTreeNodes[Begin].DBox;
+                        for(std::size_t Index = Begin + 1; Index < End; Index++){
+                            Box.Expand(DTreeNodes[Index].DBox);
+                        }
+                        DTreeNodes.push_back({Box,Begin,End,false});
+                    }
+                }
+                return EntryOrder;
+            }
+
+            // Best first search, entries are queued with their exact distance
+            // from entryDistance and tree nodes with their lower bound, so
+            // entries reach found in order of distance until count are found
+            // or the rest are beyond radius.
+            template <typename TDistance, typename TFound>
+            void Search(const CStreetMap::TLocation &loc, std::size_t count, double radius, TDistance entryDistance, TFound found) const{
+                if(DTreeNodes.empty() || !count){
+                    return;
+                }
+                struct SQueued{
+                    double DDistance;
+                    std::size_t DIndex;
+                    bool DEntry;
+                    bool operator>(const SQueued &other) const{
+                        return DDistance > other.DDistance || (DDistance == other.DDistance && DEntry < other.DEntry);
+                    }
+                };
+                std::priority_queue<SQueued, std::vector<SQueued>, std::greater<SQueued>> Queue;
+                Queue.push({MinimumDistance(loc,DTreeNodes.back().DBox),DTreeNodes.size() - 1,false});
+                std::size_t FoundCount = 0;
+                while(!Queue.empty() && FoundCount < count){
+                    auto Current = Queue.top();
+                    Queue.pop();
+                    if(Current.DDistance > radius){
+                        break;
+                    }
+                    if(Current.DEntry){
+                        found(Current.DIndex,Current.DDistance);
+                        FoundCount++;
+                        continue;
+                    }
+                    const auto &Node = DTreeNodes[Current.DIndex];
+                    for(std::size_t Index = Node.DBegin; Index < Node.DEnd; Index++){
+                        if(Node.DLeaf){
+                            Queue.push({entryDistance(Index),Index,true});
+                        }
+                        else{
+                            Queue.push({MinimumDistance(loc,DTreeNodes[Index].DBox),Index,false});
+                        }
+                    }
+                }
+            }
+    };
+}
+
+struct CSpatialIndex::SImplementation{
+    std::vector< std::pair< TNodeID, TLocation > > DEntries;
+    CPackedTree DTree;
+
+    SImplementation(const std::vector< std::pair< TNodeID, TLocation > > &nodes){
+        std::vector<SBox> Boxes;
+        Boxes.reserve(nodes.size());
+        for(auto &Node : nodes){
+            Boxes.push_back(SBox::Around(Node.second,Node.second));
+        }
+        DEntries.reserve(nodes.size());
+        for(auto Index : DTree.Build(std::move(Boxes))){
+            DEntries.push_back(nodes[Index]);
+        }
+    }
+
+    std::size_t Nearest(TLocation loc, std::size_t count, double radius, std::vector< std::pair< TNodeID, double > > &nodes) const{
+        nodes.clear();
+        DTree.Search(loc,count,radius,
+            [&](std::size_t index){
+                return SGeographicUtils::HaversineDistanceInMiles(loc,DEntries[index].second);
+            },
+            [&](std::size_t index, double distance){
+                nodes.push_back({DEntries[index].first,distance});
+            });
+        return nodes.size();
+    }
+};
+
+CSpatialIndex::CSpatialIndex(const std::vector< std::pair< TNodeID, TLocation > > &nodes){
+    DImplementation = std::make_unique<SImplementation>(nodes);
+}
+
+CSpatialIndex::CSpatialIndex(std::shared_ptr<CStreetMap> streetmap){
+    std::vector< std::pair< TNodeID, TLocation > > Nodes;
+    if(streetmap){
+        Nodes.reserve(streetmap->NodeCount());
+        for(std::size_t Index = 0; Index < streetmap->NodeCount(); Index++){
+            auto Node = streetmap->NodePtrByIndex(Index);
+            if(Node){
+                Nodes.push_back({Node->ID(),Node->Location()});
+            }
+        }
+    }
+    DImplementation = std::make_unique<SImplementation>(Nodes);
+}
+
+CSpatialIndex::~CSpatialIndex(){
+
+}
+
+std::size_t CSpatialIndex::NodeCount() const noexcept{
+    return DImplementation->DEntries.size();
+}
+
+std::size_t CSpatialIndex::MemoryUsage() const noexcept{
+    return DImplementation->DEntries.capacity() * sizeof(DImplementation->DEntries[0]) + DImplementation->DTree.MemoryUsage();
+}
+
+CSpatialIndex::TNodeID CSpatialIndex::NearestNode(TLocation loc) const noexcept{
+    std::vector< std::pair< TNodeID, double > > Nodes;
+    if(!DImplementation->Nearest(loc,1,std::numeric_limits<double>::infinity(),Nodes)){
+        return CStreetMap::InvalidNodeID;
+    }
+    return Nodes.front().first;
+}
+
+std::size_t CSpatialIndex::NearestNodes(TLocation loc, std::size_t count, std::vector< std::pair< TNodeID, double > > &nodes) const{
+    return DImplementation->Nearest(loc,count,std::numeric_limits<double>::infinity(),nodes);
+}
+
+std::size_t CSpatialIndex::NodesWithinRadius(TLocation loc, double radius, std::vector< std::pair< TNodeID, double > > &nodes) const{
+    if(!(radius >= 0.0)){
+        nodes.clear();
+        return 0;
+    }
+    return DImplementation->Nearest(loc,std::numeric_limits<std::size_t>::max(),radius,nodes);
+}
+
+struct CSegmentIndex::SImplementation{
+    std::vector<SSegment> DEntries;
+    std::vector<std::size_t> DEntryIDs;
+    CPackedTree DTree;
+
+    SImplementation(const std::vector<SSegment> &segments){
+        std::vector<SBox> Boxes;
+        Boxes.reserve(segments.size());
+        for(auto &Segment : segments){
+            Boxes.push_back(SBox::Around(Segment.DStart,Segment.DEnd));
+        }
+        DEntries.reserve(segments.size());
+        DEntryIDs.reserve(segments.size());
+        for(auto Index : DTree.Build(std::move(Boxes))){
+            DEntries.push_back(segments[Index]);
+            DEntryIDs.push_back(Index);
+        }
+    }
+
+    // Projects loc onto the segment in a local equirectangular frame, which
+    // is accurate over the length of a road segment, and measures the
+    // Haversine distance to the projected point
+    static SMatch Project(const TLocation &loc, const SSegment &segment){
+        double Scale = std::cos(SGeographicUtils::DegreesToRadians(loc.first));
+        double SegmentX = (segment.DEnd.second - segment.DStart.second) * Scale;
+        double SegmentY = segment.DEnd.first - segment.DStart.first;
+        double PointX = (loc.second - segment.DStart.second) * Scale;
+        double PointY = loc.first - segment.DStart.first;
+        double LengthSquared = SegmentX * SegmentX + SegmentY * SegmentY;
+        double Fraction = 0.0;
+        if(LengthSquared > 0.0){
+            Fraction = std::clamp((PointX * SegmentX + PointY * SegmentY) / LengthSquared,0.0,1.0);
+        }
+        TLocation Location{segment.DStart.first + Fraction * (segment.DEnd.first - segment.DStart.first),
+                           segment.DStart.second + Fraction * (segment.DEnd.second - segment.DStart.second)};
+        if(Fraction == 0.0){
+            Location = segment.DStart;
+        }
+        else if(Fraction == 1.0){
+            Location = segment.DEnd;
+        }
+        return {0,Fraction,Location,SGeographicUtils::HaversineDistanceInMiles(loc,Location)};
+    }
+
+    std::size_t Nearest(TLocation loc, std::size_t count, std::vector<SMatch> &matches) const{
+        matches.clear();
+        DTree.Search(loc,count,std::numeric_limits<double>::infinity(),
+            [&](std::size_t index){
+                return Project(loc,DEntries[index]).DDistance;
+            },
+            [&](std::size_t index, double distance){
+                matches.push_back(Project(loc,DEntries[index]));
+                matches.back().DSegment = DEntryIDs[index];
+            });
+        return matches.size();
+    }
+};
+
+CSegmentIndex::CSegmentIndex(const std::vector<SSegment> &segments){
+    DImplementation = std::make_unique<SImplementation>(segments);
+}
+
+CSegmentIndex::~CSegmentIndex(){
+
+}
+
+std::size_t CSegmentIndex::SegmentCount() const noexcept{
+    return DImplementation->DEntries.size();
+}
+
+std::size_t CSegmentIndex::MemoryUsage() const noexcept{
+    return DImplementation->DEntries.capacity() * sizeof(SSegment) + DImplementation->DEntryIDs.capacity() * sizeof(std::size_t) +
+           DImplementation->DTree.MemoryUsage();
+}
+
+bool CSegmentIndex::NearestSegment(TLocation loc, SMatch &match) const{
+    std::vector<SMatch> Matches;
+    if(!DImplementation->Nearest(loc,1,Matches)){
+        return false;
+    }
+    match = Matches.front();
+    return true;
+}
+
+std::size_t CSegmentIndex::NearestSegments(TLocation loc, std::size_t count, std::vector<SMatch> &matches) const{
+    return DImplementation->Nearest(loc,count,matches);
+}
@@ -0,0 +1,441 @@
+#include "TransportationPlannerCommandLine.h"
+#include "GeographicUtils.h"
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+struct CTransportationPlannerCommandLine::SImplementation{
+    using TNodeID = CTransportationPlanner::TNodeID;
+    using TTripStep = CTransportationPlanner::TTripStep;
+    using ETransportationMode = CTransportationPlanner::ETransportationMode;
+
+    enum class ECommandType{Empty, Help, Exit, Count, Node, Shortest, Fastest, Save, Print, Report, Unknown, Invalid};
+
+    // One parsed input line together with the result of any path query it
+    // requires, so queries can be computed apart from writing the output.
+    struct SCommand{
+        ECommandType DType = ECommandType::Empty;
+        std::string DText;
+        std::size_t DIndex = 0;
+        TNodeID DSource = 0;
+        TNodeID DDestination = 0;
+        double DResult = CPathRouter::NoPathExists;
+        std::vector<TNodeID> DShortestPath;
+        std::vector<TTripStep> DFastestPath;
+        bool DComputed = false;
+    };
+
+    std::shared_ptr<CDataSource> DCommandSource;
+    std::shared_ptr<CDataSink> DOutputSink;
+    std::shared_ptr<CDataSink> DErrorSink;
+    std::shared_ptr<CDataFactory> DResultsFactory;
+    std::shared_ptr<CTransportationPlanner> DPlanner;
+
+    bool DLastPathValid = false;
+    bool DLastPathFastest = false;
+    TNodeID DLastSource = 0;
+    TNodeID DLastDestination = 0;
+    double DLastResult = 0.0;
+    std::vector<TTripStep> DLastPath;
+
+    static const std::string DPrompt;
+    static const std::string DHelpText;
+
+    SImplementation(std::shared_ptr<CDataSource> cmdsrc, std::shared_ptr<CDataSink> outsink, std::shared_ptr<CDataSink> errsink, std::shared_ptr<CDataFactory> results, std::shared_ptr<CTransportationPlanner> planner)
+        : DCommandSource(cmdsrc), DOutputSink(outsink), DErrorSink(errsink), DResultsFactory(results), DPlanner(planner){
+
+    }
+
+    static bool WriteString(std::shared_ptr<CDataSink> sink, const std::string &str){
+        return sink->Write(std::vector<char>(str.begin(),str.end()));
+    }
+
+    bool ReadLine(std::string &line){
+        line.clear();
+        if(DCommandSource->End()){
+            return false;
+        }
+        char Ch;
+        bool ReadAny = false;
+        while(DCommandSource->Get(Ch)){
+            ReadAny = true;
+            if(Ch == '\n'){
+                break;
+            }
+            if(Ch != '\r'){
+                line += Ch;
+            }
+        }
+        return ReadAny;
+    }
+
+    static bool ParseUnsigned(const std::string &str, uint64_t &value){
+        if(str.empty()){
+            return false;
+        }
+        uint64_t Result = 0;
+        for(char Ch : str){
+            if(Ch < '0' || Ch > '9'){
+                return false;
+            }
+            Result = Result * 10 + (Ch - '0');
+        }
+        value = Result;
+        return true;
+    }
+
+    static std::vector<std::string> SplitWhitespace(const std::string &line){
+        std::vector<std::string> Words;
+        std::istringstream Stream(line);
+        std::string Word;
+        while(Stream>>Word){
+            Words.push_back(Word);
+        }
+        return Words;
+    }
+
+    static SCommand ParseCommand(const std::string &line){
+        SCommand Command;
+        auto Args = SplitWhitespace(line);
+        if(Args.empty()){
+            return Command;
+        }
+        const std::string &Name = Args[0];
+        if(Name == "help"){
+            Command.DType = ECommandType::Help;
+        }
+        else if(Name == "exit"){
+            Command.DType = ECommandType::Exit;
+        }
+        else if(Name == "count"){
+            Command.DType = ECommandType::Count;
+        }
+        else if(Name == "save"){
+            Command.DType = ECommandType::Save;
+        }
+        else if(Name == "print"){
+            Command.DType = ECommandType::Print;
+        }
+        else if(Name == "report"){
+            Command.DType = ECommandType::Report;
+        }
+        else if(Name == "node"){
+            uint64_t Index;
+            if(Args.size() != 2){
+                Command.DType = ECommandType::Invalid;
+                Command.DText = "Invalid node command, see help.\n";
+            }
+            else if(!ParseUnsigned(Args[1],Index)){
+                Command.DType = ECommandType::Invalid;
+                Command.DText = "Invalid node parameter, see help.\n";
+            }
+            else{
+                Command.DType = ECommandType::Node;
+                Command.DIndex = Index;
+            }
+        }
+        else if(Name == "shortest" || Name == "fastest"){
+            if(Args.size() != 3){
+                Command.DType = ECommandType::Invalid;
+                Command.DText = "Invalid " + Name + " command, see help.\n";
+            }
+            else if(!ParseUnsigned(Args[1],Command.DSource) || !ParseUnsigned(Args[2],Command.DDestination)){
+                Command.DType = ECommandType::Invalid;
+                Command.DText = "Invalid " + Name + " parameter, see help.\n";
+            }
+            else{
+                Command.DType = Name == "shortest" ? ECommandType::Shortest : ECommandType::Fastest;
+            }
+        }
+        else{
+            Command.DType = ECommandType::Unknown;
+            Command.DText = "Unknown command \"" + Name + "\" type help for help.\n";
+        }
+        return Command;
+    }
+
+    static bool IsPathQuery(const SCommand &command){
+        return command.DType == ECommandType::Shortest || command.DType == ECommandType::Fastest;
+    }
+
+    // Runs the planner query of a command into the given outputs, it only
+    // reads the command so it is safe to call from worker threads
+    double ComputeQuery(const SCommand &command, std::vector<TNodeID> &shortestpath, std::vector<TTripStep> &fastestpath){
+        if(command.DType == ECommandType::Shortest){
+            return DPlanner->FindShortestPath(command.DSource,command.DDestination,shortestpath);
+        }
+        if(command.DType == ECommandType::Fastest){
+            return DPlanner->FindFastestPath(command.DSource,command.DDestination,fastestpath);
+        }
+        return CPathRouter::NoPathExists;
+    }
+
+    void ComputeCommand(SCommand &command){
+        command.DResult = ComputeQuery(command,command.DShortestPath,command.DFastestPath);
+        command.DComputed = true;
+    }
+
+    static std::string FormatTime(double hours){
+        long long TotalSeconds = std::llround(hours * 3600.0);
+        long long Hours = TotalSeconds / 3600;
+        long long Minutes = (TotalSeconds / 60) % 60;
+        long long Seconds = TotalSeconds % 60;
+        std::string Result;
+        if(Hours){
+            Result += std::to_string(Hours) + " hr";
+        }
+        if(Minutes){
+            Result += (Result.empty() ? "" : " ") + std::to_string(Minutes) + " min";
+        }
+        if(Seconds || Result.empty()){
+            Result += (Result.empty() ? "" : " ") + std::to_string(Seconds) + " sec";
+        }
+        return Result;
+    }
+
+    static std::string ModeName(ETransportationMode mode){
+        switch(mode){
+            case ETransportationMode::Bike:  return "Bike";
+            case ETransportationMode::Bus:   return "Bus";
+            default:                         return "Walk";
+        }
+    }
+
+    bool SavePath(){
+        char ResultBuffer[64];
+        std::snprintf(ResultBuffer,sizeof(ResultBuffer),"%f",DLastResult);
+        std::string FileName = std::to_string(DLastSource) + "_" + std::to_string(DLastDestination) + "_" + ResultBuffer + (DLastPathFastest ? "hr" : "mi") + ".csv";
+        auto Sink = DResultsFactory->CreateSink(FileName);
+        if(!Sink){
+            return WriteString(DErrorSink,"Failed to save path, see help.\n");
+        }
+        std::string Contents = "mode,node_id";
+        for(auto &Step : DLastPath){
+            Contents += "\n" + ModeName(Step.first) + "," + std::to_string(Step.second);
+        }
+        WriteString(Sink,Contents);
+        return WriteString(DOutputSink,"Path saved to <results>/" + FileName + "\n");
+    }
+
+    // Writes the output of a command in input order and tracks the last path
+    bool EmitCommand(SCommand &command){
+        switch(command.DType){
+            case ECommandType::Empty:
+            case ECommandType::Exit:
+                return true;
+            case ECommandType::Help:
+                return WriteString(DOutputSink,DHelpText);
+            case ECommandType::Count:
+                return WriteString(DOutputSink,std::to_string(DPlanner->NodeCount()) + " nodes\n");
+            case ECommandType::Node:{
+                auto Node = command.DIndex < DPlanner->NodeCount() ? DPlanner->SortedNodeByIndex(command.DIndex) : nullptr;
+                if(!Node){
+                    return WriteString(DErrorSink,"Invalid node parameter, see help.\n");
+                }
+                return WriteString(DOutputSink,"Node " + std::to_string(command.DIndex) + ": id = " + std::to_string(Node->ID()) + " is at " + SGeographicUtils::ConvertLLToDMS(Node->Location()) + "\n");
+            }
+            case ECommandType::Shortest:
+            case ECommandType::Fastest:{
+                bool Fastest = command.DType == ECommandType::Fastest;
+                if(!command.DComputed){
+                    ComputeCommand(command);
+                }
+                if(command.DResult == CPathRouter::NoPathExists || command.DResult < 0.0){
+                    DLastPathValid = false;
+                    return WriteString(DOutputSink,"No path from " + std::to_string(command.DSource) + " to " + std::to_string(command.DDestination) + ".\n");
+                }
+                DLastPathValid = true;
+                DLastPathFastest = Fastest;
+                DLastSource = command.DSource;
+                DLastDestination = command.DDestination;
+                DLastResult = command.DResult;
+                if(Fastest){
+                    DLastPath.swap(command.DFastestPath);
+                    return WriteString(DOutputSink,"Fastest path takes " + FormatTime(command.DResult) + ".\n");
+                }
+                DLastPath.clear();
+                for(auto NodeID : command.DShortestPath){
+                    DLastPath.push_back({ETransportationMode::Walk,NodeID});
+                }
+                std::stringstream Stream;
+                Stream<<std::fixed<<std::setprecision(1)<<command.DResult;
+                return WriteString(DOutputSink,"Shortest path is " + Stream.str() + " mi.\n");
+            }
+            case ECommandType::Save:
+                if(!DLastPathValid){
+                    return WriteString(DErrorSink,"No valid path to save, see help.\n");
+                }
+                return SavePath();
+            case ECommandType::Print:{
+                std::vector<std::string> Description;
+                if(!DLastPathValid || !DPlanner->GetPathDescription(DLastPath,Description)){
+                    return WriteString(DErrorSink,"No valid path to print, see help.\n");
+                }
+                std::string Output;
+                for(auto &Line : Description){
+                    Output += Line + "\n";
+                }
+                return WriteString(DOutputSink,Output);
+            }
+            case ECommandType::Report:{
+                std::vector<SConstructionReport> Reports;
+                if(!DPlanner->ConstructionReports(Reports) || Reports.empty()){
+                    return WriteString(DErrorSink,"No construction report available.\n");
+                }
+                std::string Output;
+                for(auto &Report : Reports){
+                    Output += Report.ToString();
+                }
+                return WriteString(DOutputSink,Output);
+            }
+            default:
+                return WriteString(DErrorSink,command.DText);
+        }
+    }
+
+    bool ProcessCommands(){
+        std::string Line;
+        while(true){
+            WriteString(DOutputSink,DPrompt);
+            if(!ReadLine(Line)){
+                return true;
+            }
+            auto Command = ParseCommand(Line);
+            if(Command.DType == ECommandType::Exit){
+                return true;
+            }
+            EmitCommand(Command);
+        }
+    }
+
+    // Batch mode: the calling thread reads and parses commands, a pool of
+    // workers computes path queries and a writer thread emits results in
+    // input order as soon as each command at the head of the queue is done.
+    bool ProcessBatchCommands(std::size_t workers){
+        if(workers == 0){
+            workers = std::max<std::size_t>(1,std::thread::hardware_concurrency());
+        }
+        const std::size_t MaxPendingCommands = 256 * workers;
+        std::mutex Mutex;
+        std::condition_variable WorkReady, ResultReady, SpaceReady;
+        std::deque<std::shared_ptr<SCommand>> OrderedCommands;
+        std::deque<std::shared_ptr<SCommand>> WorkQueue;
+        bool InputDone = false;
+
+        auto WorkerMain = [&](){
+            std::unique_lock<std::mutex> Lock(Mutex);
+            while(true){
+                WorkReady.wait(Lock,[&](){ return !WorkQueue.empty() || InputDone; });
+                if(WorkQueue.empty()){
+                    return;
+                }
+                auto Command = WorkQueue.front();
+                WorkQueue.pop_front();
+                Lock.unlock();
+                std::vector<TNodeID> ShortestPath;
+                std::vector<TTripStep> FastestPath;
+                double Result = ComputeQuery(*Command,ShortestPath,FastestPath);
+                // The writer reads the results once it sees DComputed under
+                // the mutex, so they are published under it as well
+                Lock.lock();
+                Command->DResult = Result;
+                Command->DShortestPath.swap(ShortestPath);
+                Command->DFastestPath.swap(FastestPath);
+                Command->DComputed = true;
+                ResultReady.notify_all();
+            }
+        };
+
+        auto WriterMain = [&](){
+            std::unique_lock<std::mutex> Lock(Mutex);
+            while(true){
+                ResultReady.wait(Lock,[&](){ return (!OrderedCommands.empty() && OrderedCommands.front()->DComputed) || (OrderedCommands.empty() && InputDone); });
+                if(OrderedCommands.empty()){
+                    return;
+                }
+                auto Command = OrderedCommands.front();
+                OrderedCommands.pop_front();
+                SpaceReady.notify_one();
+                Lock.unlock();
+                EmitCommand(*Command);
+                Lock.lock();
+            }
+        };
+
+        std::vector<std::thread> Threads;
+        for(std::size_t Index = 0; Index < workers; Index++){
+            Threads.emplace_back(WorkerMain);
+        }
+        std::thread Writer(WriterMain);
+
+        std::string Line;
+        while(ReadLine(Line)){
+            auto Command = std::make_shared<SCommand>(ParseCommand(Line));
+            if(Command->DType == ECommandType::Exit){
+                break;
+            }
+            bool Query = IsPathQuery(*Command);
+            Command->DComputed = !Query;
+            std::unique_lock<std::mutex> Lock(Mutex);
+            SpaceReady.wait(Lock,[&](){ return OrderedCommands.size() < MaxPendingCommands; });
+            OrderedCommands.push_back(Command);
+            if(Query){
+                WorkQueue.push_back(Command);
+                WorkReady.notify_one();
+            }
+            else{
+                ResultReady.notify_all();
+            }
+        }
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            InputDone = true;
+        }
+        WorkReady.notify_all();
+        ResultReady.notify_all();
+        for(auto &Thread : Threads){
+            Thread.join();
+        }
+        Writer.join();
+        return true;
+    }
+};
+
+const std::string CTransportationPlannerCommandLine::SImplementation::DPrompt = "> ";
+const std::string CTransportationPlannerCommandLine::SImplementation::DHelpText =
+    "------------------------------------------------------------------------\n"
+    "help     Display this help menu\n"
+    "exit     Exit the program\n"
+    "count    Output the number of nodes in the map\n"
+    "node     Syntax \"node [0, count)\" \n"
+    "         Will output node ID and Lat/Lon for node\n"
+    "fastest  Syntax \"fastest start end\" \n"
+    "         Calculates the time for fastest path from start to end\n"
+    "shortest Syntax \"shortest start end\" \n"
+    "         Calculates the distance for the shortest path from start to end\n"
+    "save     Saves the last calculated path to file\n"
+    "print    Prints the steps for the last calculated path\n"
+    "report   Prints the load time and memory use of the map and planner\n";
+
+CTransportationPlannerCommandLine::CTransportationPlannerCommandLine(std::shared_ptr<CDataSource> cmdsrc, std::shared_ptr<CDataSink> outsink, std::shared_ptr<CDataSink> errsink, std::shared_ptr<CDataFactory> results, std::shared_ptr<CTransportationPlanner> planner){
+    DImplementation = std::make_unique<SImplementation>(cmdsrc,outsink,errsink,results,planner);
+}
+
+CTransportationPlannerCommandLine::~CTransportationPlannerCommandLine(){
+
+}
+
+bool CTransportationPlannerCommandLine::ProcessCommands(){
+    return DImplementation->ProcessCommands();
+}
+
+bool CTransportationPlannerCommandLine::ProcessBatchCommands(std::size_t workers){
+    return DImplementation->ProcessBatchCommands(workers);
+}
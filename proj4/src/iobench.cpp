@@ -0,0 +1,246 @@
+#include "DSVReader.h"
+#include "DSVWriter.h"
+#include "XMLReader.h"
+#include "XMLWriter.h"
+#include "KMLWriter.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+#include "StandardDataSink.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Microbenchmarks for the DSV, XML and KML layers over synthetic inputs.
+// Each case is run several times and the fastest run is reported, one CSV
+// row per case written through CDSVWriter to standard output.
+//
+//      iobench [records] [repeats]
+
+namespace{
+    std::atomic<std::size_t> AllocationCount{0};
+}
+
+void *operator new(std::size_t size){
+    AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if(void *Pointer = std::malloc(size ? size : 1)){
+        return Pointer;
+    }
+    throw std::bad_alloc();
+}
+
+// GCC cannot see that these deletes pair with the malloc based new above
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void *pointer) noexcept{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept{
+    std::free(pointer);
+}
+#pragma GCC diagnostic pop
+
+namespace{
+    using TClock = std::chrono::steady_clock;
+
+    struct SResult{
+        double DSeconds = 0.0;
+        std::size_t DBytes = 0;
+        std::size_t DAllocations = 0;
+    };
+
+    // Runs body repeats times keeping the fastest, body returns the number of
+    // bytes it read or wrote
+    SResult Measure(int repeats, const std::function<std::size_t()> &body){
+        SResult Result;
+        for(int Run = 0; Run < repeats; Run++){
+            std::size_t StartAllocations = AllocationCount.load(std::memory_order_relaxed);
+            auto Start = TClock::now();
+            std::size_t Bytes = body();
+            double Seconds = std::chrono::duration<double>(TClock::now() - Start).count();
+            std::size_t Allocations = AllocationCount.load(std::memory_order_relaxed) - StartAllocations;
+            if(!Run || Seconds < Result.DSeconds){
+                Result.DSeconds = Seconds;
+                Result.DBytes = Bytes;
+                Result.DAllocations = Allocations;
+            }
+        }
+        return Result;
+    }
+
+    template <typename T>
+    std::string ToString(T value){
+        std::stringstream Stream;
+        Stream<<value;
+        return Stream.str();
+    }
+
+    struct SCase{
+        std::string DLayer;
+        std::string DOperation;
+        std::size_t DRecords = 0;
+        std::size_t DCells = 0;
+        std::size_t DCellBytes = 0;
+        double DQuotedFraction = 0.0;
+        std::size_t DAttributes = 0;
+    };
+
+    void Report(CDSVWriter &writer, const SCase &benchcase, const SResult &result){
+        double Megabytes = result.DBytes / (1024.0 * 1024.0);
+        writer.WriteRow({benchcase.DLayer, benchcase.DOperation, ToString(benchcase.DRecords), ToString(benchcase.DCells),
+                         ToString(benchcase.DCellBytes), ToString(benchcase.DQuotedFraction), ToString(benchcase.DAttributes),
+                         ToString(result.DBytes), ToString(result.DSeconds),
+                         ToString(result.DSeconds > 0.0 ? Megabytes / result.DSeconds : 0.0),
+                         ToString(benchcase.DRecords ? double(result.DAllocations) / benchcase.DRecords : 0.0)});
+    }
+
+    // Cells picked for quoting carry a delimiter and a quote so the writer
+    // has to quote and escape them
+    std::vector<std::vector<std::string>> GenerateRows(std::mt19937 &generator, const SCase &benchcase){
+        std::uniform_int_distribution<int> Letter('a', 'z');
+        std::bernoulli_distribution Quoted(benchcase.DQuotedFraction);
+        std::vector<std::vector<std::string>> Rows(benchcase.DRecords);
+        for(auto &Row : Rows){
+            for(std::size_t Cell = 0; Cell < benchcase.DCells; Cell++){
+                std::string Value(benchcase.DCellBytes, ' ');
+                for(auto &Ch : Value){
+                    Ch = char(Letter(generator));
+                }
+                if(Quoted(generator) && Value.size() >= 2){
+                    Value[Value.size() / 3] = ',';
+                    Value[(2 * Value.size()) / 3] = '"';
+                }
+                Row.push_back(Value);
+            }
+        }
+        return Rows;
+    }
+
+    std::vector<SXMLEntity> GenerateEntities(std::mt19937 &generator, const SCase &benchcase){
+        std::uniform_int_distribution<long> Number(0, 999999999);
+        std::vector<SXMLEntity> Entities;
+        Entities.push_back({SXMLEntity::EType::StartElement, "osm", {{"version", "0.6"}}});
+        for(std::size_t Index = 0; Index < benchcase.DRecords; Index++){
+            SXMLEntity Entity{SXMLEntity::EType::CompleteElement, "node", {}};
+            Entity.DAttributes.push_back({"id", ToString(Index + 1)});
+            for(std::size_t Attribute = 1; Attribute < benchcase.DAttributes; Attribute++){
+                Entity.DAttributes.push_back({"k" + ToString(Attribute), ToString(Number(generator))});
+            }
+            Entities.push_back(Entity);
+        }
+        Entities.push_back({SXMLEntity::EType::EndElement, "osm", {}});
+        return Entities;
+    }
+
+    std::string WriteRows(const std::vector<std::vector<std::string>> &rows){
+        auto Sink = std::make_shared<CStringDataSink>();
+        CDSVWriter Writer(Sink, ',');
+        for(auto &Row : rows){
+            Writer.WriteRow(Row);
+        }
+        return Sink->String();
+    }
+
+    std::string WriteEntities(const std::vector<SXMLEntity> &entities){
+        auto Sink = std::make_shared<CStringDataSink>();
+        CXMLWriter Writer(Sink);
+        for(auto &Entity : entities){
+            Writer.WriteEntity(Entity);
+        }
+        Writer.Flush();
+        return Sink->String();
+    }
+
+    void BenchmarkDSV(CDSVWriter &report, std::mt19937 &generator, std::size_t records, int repeats){
+        for(std::size_t Cells : {4, 16}){
+            for(std::size_t CellBytes : {8, 64}){
+                for(double QuotedFraction : {0.0, 0.25, 1.0}){
+                    SCase Case{"dsv", "write", records, Cells, CellBytes, QuotedFraction, 0};
+                    auto Rows = GenerateRows(generator, Case);
+                    Report(report, Case, Measure(repeats, [&](){
+                        return WriteRows(Rows).size();
+                    }));
+
+                    Case.DOperation = "read";
+                    std::string Input = WriteRows(Rows);
+                    Report(report, Case, Measure(repeats, [&](){
+                        CDSVReader Reader(std::make_shared<CStringDataSource>(Input), ',');
+                        std::vector<std::string> Row;
+                        while(Reader.ReadRow(Row)){
+                        }
+                        return Input.size();
+                    }));
+                }
+            }
+        }
+    }
+
+    void BenchmarkXML(CDSVWriter &report, std::mt19937 &generator, std::size_t records, int repeats){
+        for(std::size_t Attributes : {1, 4, 16}){
+            SCase Case{"xml", "write", records, 0, 0, 0.0, Attributes};
+            auto Entities = GenerateEntities(generator, Case);
+            Report(report, Case, Measure(repeats, [&](){
+                return WriteEntities(Entities).size();
+            }));
+
+            Case.DOperation = "read";
+            std::string Input = WriteEntities(Entities);
+            Report(report, Case, Measure(repeats, [&](){
+                CXMLReader Reader(std::make_shared<CStringDataSource>(Input));
+                SXMLEntity Entity;
+                while(Reader.ReadEntity(Entity, true)){
+                }
+                return Input.size();
+            }));
+        }
+    }
+
+    // Records are placemarks, one path for every ten points
+    void BenchmarkKML(CDSVWriter &report, std::mt19937 &generator, std::size_t records, int repeats){
+        const std::size_t PathPoints = 50;
+        std::uniform_real_distribution<double> Coordinate(-1.0, 1.0);
+        std::vector<CStreetMap::TLocation> Points(records);
+        for(auto &Point : Points){
+            Point = {38.5 + Coordinate(generator), -121.7 + Coordinate(generator)};
+        }
+        std::size_t PathCount = records >= PathPoints ? (records - PathPoints) / 10 + 1 : 0;
+        SCase Case{"kml", "write", records + PathCount, 0, 0, 0.0, 0};
+        Report(report, Case, Measure(repeats, [&](){
+            auto Sink = std::make_shared<CStringDataSink>();
+            {
+                CKMLWriter Writer(Sink, "Benchmark", "Synthetic placemarks");
+                Writer.CreatePointStyle("point", 0xff0000ff);
+                Writer.CreateLineStyle("path", 0xff00ff00, 3);
+                for(std::size_t Index = 0; Index < Points.size(); Index++){
+                    Writer.CreatePoint("Point " + ToString(Index), "", "point", Points[Index]);
+                }
+                for(std::size_t Path = 0; Path < PathCount; Path++){
+                    auto Begin = Points.begin() + Path * 10;
+                    Writer.CreatePath("Path " + ToString(Path), "path", std::vector<CStreetMap::TLocation>(Begin, Begin + PathPoints));
+                }
+            }
+            return Sink->String().size();
+        }));
+    }
+}
+
+int main(int argc, char *argv[]){
+    std::size_t Records = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    int Repeats = std::max(argc > 2 ? std::atoi(argv[2]) : 3, 1);
+
+    CDSVWriter Report(std::make_shared<CStandardDataSink>(), ',');
+    Report.WriteRow({"layer", "operation", "records", "cells", "cell_bytes", "quoted_fraction", "attributes",
+                     "bytes", "seconds", "mb_per_s", "allocations_per_record"});
+    std::mt19937 Generator(1);
+    BenchmarkDSV(Report, Generator, Records, Repeats);
+    BenchmarkXML(Report, Generator, Records, Repeats);
+    BenchmarkKML(Report, Generator, Records, Repeats);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,275 @@
+#include "XMLWriter.h"
+#include "DSVWriter.h"
+#include "FileDataSink.h"
+#include "StreetMap.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Synthetic map generator for scale testing. Writes city.osm, stops.csv and
+// routes.csv into outdir, laid out like the bundled data so the benchmarks
+// can load them in its place:
+//
+//      mapgen outdir [rows] [columns] [seed] [shapenodes]
+//
+// Streets follow a rows by columns grid of intersections with every tenth
+// row and column an arterial carrying a bus route. Intersections and the
+// shape nodes along each block are jittered, residential blocks are
+// occasionally missing and some residential streets are oneway. Everything
+// is streamed to the files, a 1000 x 1000 grid writes 3M nodes.
+
+namespace{
+    using TNodeID = CStreetMap::TNodeID;
+
+    const TNodeID BaseNodeID = 1000000000;
+    const double BaseLatitude = 38.5;
+    const double BaseLongitude = -121.8;
+    // About 110 m north-south and 87 m east-west at this latitude
+    const double Spacing = 0.001;
+    const std::size_t ArterialInterval = 10;
+    const std::size_t StopInterval = 4;
+
+    struct SGrid{
+        std::size_t DRows;
+        std::size_t DColumns;
+        std::size_t DShapeNodes;
+        uint64_t DSeed;
+
+        // Counter based randomness so nodes and ways can be written in any
+        // order without storing the layout
+        uint64_t Hash(uint64_t a, uint64_t b, uint64_t c) const{
+            uint64_t Value = DSeed ^ (a * 0x9E3779B97F4A7C15ULL) ^ (b * 0xC2B2AE3D27D4EB4FULL) ^ (c * 0x165667B19E3779F9ULL);
+            Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBULL;
+            return Value ^ (Value >> 31);
+        }
+
+        // Uniform in [-0.5, 0.5)
+        double Jitter(uint64_t a, uint64_t b, uint64_t c) const{
+            return double(Hash(a, b, c) >> 11) / double(1ULL << 53) - 0.5;
+        }
+
+        bool Arterial(std::size_t line) const{
+            return line % ArterialInterval == 0;
+        }
+
+        TNodeID IntersectionID(std::size_t row, std::size_t column) const{
+            return BaseNodeID + row * DColumns + column;
+        }
+
+        // Shape nodes of the block leaving (row, column) eastwards or
+        // northwards
+        TNodeID ShapeID(std::size_t row, std::size_t column, bool vertical, std::size_t index) const{
+            TNodeID Block = vertical ? DRows * (DColumns - 1) + row * DColumns + column : row * (DColumns - 1) + column;
+            return BaseNodeID + DRows * DColumns + Block * DShapeNodes + index;
+        }
+
+        bool BlockExists(std::size_t row, std::size_t column, bool vertical) const{
+            if(vertical ? (row + 1 >= DRows || Arterial(column)) : (column + 1 >= DColumns || Arterial(row))){
+                return vertical ? row + 1 < DRows : column + 1 < DColumns;
+            }
+            return Hash(row, column, vertical ? 2 : 1) % 100 >= 5;
+        }
+
+        CStreetMap::TLocation IntersectionLocation(std::size_t row, std::size_t column) const{
+            return {BaseLatitude + Spacing * (row + 0.3 * Jitter(row, column, 3)),
+                    BaseLongitude + Spacing * (column + 0.3 * Jitter(row, column, 4))};
+        }
+
+        CStreetMap::TLocation ShapeLocation(std::size_t row, std::size_t column, bool vertical, std::size_t index) const{
+            auto Start = IntersectionLocation(row, column);
+            auto End = vertical ? IntersectionLocation(row + 1, column) : IntersectionLocation(row, column + 1);
+            double Fraction = double(index + 1) / (DShapeNodes + 1);
+            uint64_t Key = ShapeID(row, column, vertical, index);
+            return {Start.first + (End.first - Start.first) * Fraction + Spacing * 0.1 * Jitter(Key, 0, 5),
+                    Start.second + (End.second - Start.second) * Fraction + Spacing * 0.1 * Jitter(Key, 0, 6)};
+        }
+    };
+
+    std::string FormatCoordinate(double value){
+        char Buffer[32];
+        std::snprintf(Buffer, sizeof(Buffer), "%.7f", value);
+        return Buffer;
+    }
+
+    void WriteNode(CXMLWriter &writer, TNodeID id, CStreetMap::TLocation location){
+        writer.WriteEntity({SXMLEntity::EType::CharData, "\n\t", {}});
+        writer.WriteEntity({SXMLEntity::EType::CompleteElement, "node", {{"id", std::to_string(id)},
+                            {"lat", FormatCoordinate(location.first)}, {"lon", FormatCoordinate(location.second)}}});
+    }
+
+    std::size_t WriteNodes(CXMLWriter &writer, const SGrid &grid){
+        std::size_t Count = grid.DRows * grid.DColumns;
+        for(std::size_t Row = 0; Row < grid.DRows; Row++){
+            for(std::size_t Column = 0; Column < grid.DColumns; Column++){
+                WriteNode(writer, grid.IntersectionID(Row, Column), grid.IntersectionLocation(Row, Column));
+            }
+        }
+        for(bool Vertical : {false, true}){
+            for(std::size_t Row = 0; Row < grid.DRows; Row++){
+                for(std::size_t Column = 0; Column < grid.DColumns; Column++){
+                    if(!grid.BlockExists(Row, Column, Vertical)){
+                        continue;
+                    }
+                    for(std::size_t Index = 0; Index < grid.DShapeNodes; Index++){
+                        WriteNode(writer, grid.ShapeID(Row, Column, Vertical, Index), grid.ShapeLocation(Row, Column, Vertical, Index));
+                    }
+                    Count += grid.DShapeNodes;
+                }
+            }
+        }
+        return Count;
+    }
+
+    void WriteWay(CXMLWriter &writer, uint64_t id, const std::vector<TNodeID> &nodes, const std::vector<SXMLEntity::TAttribute> &tags){
+        writer.WriteEntity({SXMLEntity::EType::CharData, "\n\t", {}});
+        writer.WriteEntity({SXMLEntity::EType::StartElement, "way", {{"id", std::to_string(id)}}});
+        for(auto NodeID : nodes){
+            writer.WriteEntity({SXMLEntity::EType::CharData, "\n\t\t", {}});
+            writer.WriteEntity({SXMLEntity::EType::CompleteElement, "nd", {{"ref", std::to_string(NodeID)}}});
+        }
+        for(auto &Tag : tags){
+            writer.WriteEntity({SXMLEntity::EType::CharData, "\n\t\t", {}});
+            writer.WriteEntity({SXMLEntity::EType::CompleteElement, "tag", {{"k", Tag.first}, {"v", Tag.second}}});
+        }
+        writer.WriteEntity({SXMLEntity::EType::CharData, "\n\t", {}});
+        writer.WriteEntity({SXMLEntity::EType::EndElement, "way", {}});
+    }
+
+    // Each street line becomes one way per unbroken run of blocks. Oneway
+    // residential streets alternate direction like a real street grid.
+    std::size_t WriteWays(CXMLWriter &writer, const SGrid &grid){
+        uint64_t WayID = 1;
+        std::vector<TNodeID> Nodes;
+        for(bool Vertical : {false, true}){
+            std::size_t Lines = Vertical ? grid.DColumns : grid.DRows;
+            std::size_t Length = Vertical ? grid.DRows : grid.DColumns;
+            for(std::size_t Line = 0; Line < Lines; Line++){
+                std::vector<SXMLEntity::TAttribute> Tags;
+                bool Oneway = false;
+                if(grid.Arterial(Line)){
+                    Tags = {{"highway", "primary"}, {"maxspeed", "35 mph"}};
+                }
+                else{
+                    Tags = {{"highway", "residential"}};
+                    if(grid.Hash(Line, Vertical, 7) % 2){
+                        Tags.push_back({"maxspeed", "25 mph"});
+                    }
+                    if(Line % 3 == 1){
+                        Tags.push_back({"oneway", "yes"});
+                        Oneway = true;
+                    }
+                }
+                Tags.push_back({"name", (Vertical ? "Avenue " : "Street ") + std::to_string(Line + 1)});
+                bool Reverse = Oneway && Line % 6 == 4;
+                for(std::size_t Start = 0; Start + 1 < Length;){
+                    Nodes.clear();
+                    std::size_t Position = Start;
+                    for(; Position + 1 < Length; Position++){
+                        std::size_t Row = Vertical ? Position : Line;
+                        std::size_t Column = Vertical ? Line : Position;
+                        if(!grid.BlockExists(Row, Column, Vertical)){
+                            break;
+                        }
+                        Nodes.push_back(grid.IntersectionID(Row, Column));
+                        for(std::size_t Index = 0; Index < grid.DShapeNodes; Index++){
+                            Nodes.push_back(grid.ShapeID(Row, Column, Vertical, Index));
+                        }
+                    }
+                    if(!Nodes.empty()){
+                        Nodes.push_back(Vertical ? grid.IntersectionID(Position, Line) : grid.IntersectionID(Line, Position));
+                        if(Reverse){
+                            Nodes.assign(Nodes.rbegin(), Nodes.rend());
+                        }
+                        WriteWay(writer, WayID++, Nodes, Tags);
+                    }
+                    Start = Position + 1;
+                }
+            }
+        }
+        return WayID - 1;
+    }
+
+    // One route along each arterial with a stop every few intersections,
+    // crossing routes share the stop at their intersection
+    bool WriteBusSystem(const std::string &outdir, const SGrid &grid, std::size_t &stopcount, std::size_t &routecount){
+        std::unordered_map<TNodeID, std::size_t> StopIDs;
+        std::vector<TNodeID> StopNodes;
+        auto Routes = std::make_shared<CFileDataSink>(outdir + "/routes.csv");
+        CDSVWriter RouteWriter(Routes, ',');
+        if(!RouteWriter.WriteRow({"route", "stop_id"})){
+            return false;
+        }
+        routecount = 0;
+        for(bool Vertical : {false, true}){
+            std::size_t Lines = Vertical ? grid.DColumns : grid.DRows;
+            std::size_t Length = Vertical ? grid.DRows : grid.DColumns;
+            for(std::size_t Line = 0; Line < Lines; Line += ArterialInterval){
+                if(Length < 2){
+                    continue;
+                }
+                std::string Name = (Vertical ? "A" : "S") + std::to_string(Line + 1);
+                for(std::size_t Position = 0; Position < Length; Position += StopInterval){
+                    TNodeID NodeID = Vertical ? grid.IntersectionID(Position, Line) : grid.IntersectionID(Line, Position);
+                    auto Search = StopIDs.find(NodeID);
+                    if(Search == StopIDs.end()){
+                        Search = StopIDs.insert({NodeID, StopNodes.size() + 1}).first;
+                        StopNodes.push_back(NodeID);
+                    }
+                    RouteWriter.WriteRow({Name, std::to_string(Search->second)});
+                }
+                routecount++;
+            }
+        }
+        auto Stops = std::make_shared<CFileDataSink>(outdir + "/stops.csv");
+        CDSVWriter StopWriter(Stops, ',');
+        if(!StopWriter.WriteRow({"stop_id", "node_id"})){
+            return false;
+        }
+        for(std::size_t Index = 0; Index < StopNodes.size(); Index++){
+            StopWriter.WriteRow({std::to_string(Index + 1), std::to_string(StopNodes[Index])});
+        }
+        stopcount = StopNodes.size();
+        return true;
+    }
+}
+
+int main(int argc, char *argv[]){
+    if(argc < 2){
+        std::cerr<<"Usage: "<<argv[0]<<" outdir [rows] [columns] [seed] [shapenodes]"<<std::endl;
+        return EXIT_FAILURE;
+    }
+    std::string OutDir = argv[1];
+    SGrid Grid;
+    Grid.DRows = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100;
+    Grid.DColumns = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : Grid.DRows;
+    Grid.DSeed = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1;
+    Grid.DShapeNodes = argc > 5 ? std::strtoul(argv[5], nullptr, 10) : 1;
+    if(!Grid.DRows || !Grid.DColumns){
+        std::cerr<<"Grid must have at least one row and column"<<std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto MapSink = std::make_shared<CFileDataSink>(OutDir + "/city.osm");
+    CXMLWriter MapWriter(MapSink);
+    if(!MapWriter.WriteEntity({SXMLEntity::EType::StartElement, "osm", {{"version", "0.6"}, {"generator", "mapgen"}}})){
+        std::cerr<<"Unable to write "<<OutDir<<"/city.osm"<<std::endl;
+        return EXIT_FAILURE;
+    }
+    std::size_t NodeCount = WriteNodes(MapWriter, Grid);
+    std::size_t WayCount = WriteWays(MapWriter, Grid);
+    MapWriter.WriteEntity({SXMLEntity::EType::CharData, "\n", {}});
+    MapWriter.Flush();
+
+    std::size_t StopCount = 0, RouteCount = 0;
+    if(!WriteBusSystem(OutDir, Grid, StopCount, RouteCount)){
+        std::cerr<<"Unable to write "<<OutDir<<"/stops.csv and routes.csv"<<std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout<<NodeCount<<" nodes, "<<WayCount<<" ways, "<<StopCount<<" stops, "<<RouteCount<<" routes written to "<<OutDir<<std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,180 @@
+#include "DijkstraTransportationPlanner.h"
+#include "TransportationPlannerConfig.h"
+#include "OpenStreetMap.h"
+#include "CSVBusSystem.h"
+#include "FileDataSource.h"
+#include "XMLReader.h"
+#include "DSVReader.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Routing benchmark: times each construction phase over data/city.osm,
+// stops.csv and routes.csv, then runs a reproducible random workload of
+// shortest and fastest path queries.
+//
+//      speedtest [datadir] [queries] [seed] [precomputeseconds]
+
+namespace{
+    using TClock = std::chrono::steady_clock;
+
+    double ElapsedMilliseconds(TClock::time_point start){
+        return std::chrono::duration<double, std::milli>(TClock::now() - start).count();
+    }
+
+    double Percentile(const std::vector<double> &sorted, double fraction){
+        if(sorted.empty()){
+            return 0.0;
+        }
+        std::size_t Index = static_cast<std::size_t>(fraction * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(Index, sorted.size() - 1)];
+    }
+
+    void PrintPhase(const std::string &name, double milliseconds){
+        std::cout<<std::left<<std::setw(24)<<name<<std::right<<std::setw(12)<<std::fixed<<std::setprecision(2)<<milliseconds<<" ms"<<std::endl;
+    }
+
+    // Latencies are in microseconds, unreachable pairs are still timed since
+    // exhausting the search is part of the workload
+    void PrintQueries(const std::string &name, std::vector<double> &latencies, std::size_t found, double totalmilliseconds){
+        std::sort(latencies.begin(), latencies.end());
+        std::cout<<std::left<<std::setw(10)<<name<<std::right
+                 <<std::setw(8)<<latencies.size()<<" queries "
+                 <<std::setw(8)<<found<<" found "
+                 <<std::setw(10)<<std::fixed<<std::setprecision(1)<<(latencies.size() * 1000.0 / std::max(totalmilliseconds, 1e-9))<<" q/s  "
+                 <<"p50 "<<std::setw(9)<<Percentile(latencies, 0.50)<<" us  "
+                 <<"p95 "<<std::setw(9)<<Percentile(latencies, 0.95)<<" us  "
+                 <<"p99 "<<std::setw(9)<<Percentile(latencies, 0.99)<<" us"<<std::endl;
+    }
+
+    // Averages per router search, a planner query may run more than one
+    void PrintSearchStatistics(const std::string &name, const CDijkstraPathRouter::SSearchStatistics &stats){
+        double Searches = std::max<std::size_t>(stats.DSearches, 1);
+        std::cout<<std::left<<std::setw(10)<<name<<std::right
+                 <<std::setw(8)<<stats.DSearches<<" searches  "<<std::fixed<<std::setprecision(1)
+                 <<"settled "<<stats.DSettledVertices / Searches<<"  "
+                 <<"relaxed "<<stats.DRelaxedEdges / Searches<<"  "
+                 <<"pushes "<<stats.DHeapPushes / Searches<<"  "
+                 <<"pops "<<stats.DHeapPops / Searches<<"  "
+                 <<"max heap "<<stats.DMaxHeapSize<<"  "
+                 <<"setup/search/path "<<stats.DSetupTime.count() / Searches / 1000.0<<"/"
+                 <<stats.DSearchTime.count() / Searches / 1000.0<<"/"
+                 <<stats.DPathTime.count() / Searches / 1000.0<<" us"<<std::endl;
+    }
+}
+
+int main(int argc, char *argv[]){
+    std::string DataPath = argc > 1 ? argv[1] : "data";
+    std::size_t QueryCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000;
+    unsigned long Seed = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 1;
+    int PrecomputeSeconds = argc > 4 ? std::atoi(argv[4]) : 30;
+
+    std::string OSMFile = DataPath + "/city.osm";
+    std::string StopsFile = DataPath + "/stops.csv";
+    std::string RoutesFile = DataPath + "/routes.csv";
+
+    // Tokenizing alone, COpenStreetMap parses again while it builds
+    auto Start = TClock::now();
+    std::size_t EntityCount = 0;
+    {
+        CXMLReader Reader(std::make_shared<CFileDataSource>(OSMFile));
+        SXMLEntity Entity;
+        while(Reader.ReadEntity(Entity, true)){
+            EntityCount++;
+        }
+    }
+    double ParseTime = ElapsedMilliseconds(Start);
+    if(!EntityCount){
+        std::cerr<<"Unable to read "<<OSMFile<<std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Start = TClock::now();
+    auto StreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(std::make_shared<CFileDataSource>(OSMFile)));
+    double StreetMapTime = ElapsedMilliseconds(Start);
+
+    Start = TClock::now();
+    auto StopReader = std::make_shared<CDSVReader>(std::make_shared<CFileDataSource>(StopsFile), ',');
+    auto RouteReader = std::make_shared<CDSVReader>(std::make_shared<CFileDataSource>(RoutesFile), ',');
+    auto BusSystem = std::make_shared<CCSVBusSystem>(StopReader, RouteReader);
+    double BusSystemTime = ElapsedMilliseconds(Start);
+
+    Start = TClock::now();
+    auto Planner = std::make_shared<CDijkstraTransportationPlanner>(std::make_shared<STransportationPlannerConfig>(StreetMap, BusSystem, 3.0, 8.0, 25.0, 30.0, PrecomputeSeconds));
+    double PlannerTime = ElapsedMilliseconds(Start);
+
+    // The planner builds its hierarchy on the first request for travel time
+    // trees, timed here with the single tree that request computes
+    Start = TClock::now();
+    std::vector<std::vector<double>> Trees;
+    if(Planner->NodeCount()){
+        Planner->FindTravelTimeTrees({Planner->SortedNodePtrByIndex(0)->ID()}, Trees);
+    }
+    double PrecomputeTime = ElapsedMilliseconds(Start);
+
+    std::cout<<"Map: "<<StreetMap->NodeCount()<<" nodes, "<<StreetMap->WayCount()<<" ways, "
+             <<BusSystem->StopCount()<<" stops, "<<BusSystem->RouteCount()<<" routes"<<std::endl;
+    PrintPhase("XML parse", ParseTime);
+    PrintPhase("OSM build", StreetMapTime);
+    PrintPhase("Bus system build", BusSystemTime);
+    PrintPhase("Planner build", PlannerTime);
+    PrintPhase("Precompute", PrecomputeTime);
+
+    std::size_t NodeCount = Planner->NodeCount();
+    if(!NodeCount){
+        return EXIT_SUCCESS;
+    }
+    std::mt19937_64 Generator(Seed);
+    std::uniform_int_distribution<std::size_t> NodeDistribution(0, NodeCount - 1);
+    std::vector<std::pair<CStreetMap::TNodeID, CStreetMap::TNodeID>> Pairs;
+    for(std::size_t Index = 0; Index < QueryCount; Index++){
+        Pairs.push_back({Planner->SortedNodePtrByIndex(NodeDistribution(Generator))->ID(),
+                         Planner->SortedNodePtrByIndex(NodeDistribution(Generator))->ID()});
+    }
+
+    std::vector<double> Latencies;
+    std::size_t Found = 0;
+    std::vector<CStreetMap::TNodeID> ShortestPath;
+    Start = TClock::now();
+    for(auto &Pair : Pairs){
+        auto QueryStart = TClock::now();
+        if(Planner->FindShortestPath(Pair.first, Pair.second, ShortestPath) != CPathRouter::NoPathExists){
+            Found++;
+        }
+        Latencies.push_back(ElapsedMilliseconds(QueryStart) * 1000.0);
+    }
+    PrintQueries("Shortest", Latencies, Found, ElapsedMilliseconds(Start));
+
+    Latencies.clear();
+    Found = 0;
+    std::vector<CTransportationPlanner::TTripStep> FastestPath;
+    Start = TClock::now();
+    for(auto &Pair : Pairs){
+        auto QueryStart = TClock::now();
+        if(Planner->FindFastestPath(Pair.first, Pair.second, FastestPath) != CPathRouter::NoPathExists){
+            Found++;
+        }
+        Latencies.push_back(ElapsedMilliseconds(QueryStart) * 1000.0);
+    }
+    PrintQueries("Fastest", Latencies, Found, ElapsedMilliseconds(Start));
+
+    // Search work is gathered in a separate untimed pass so the latencies
+    // above are measured without instrumentation
+    Planner->SetSearchStatisticsEnabled(true);
+    for(auto &Pair : Pairs){
+        Planner->FindShortestPath(Pair.first, Pair.second, ShortestPath);
+    }
+    PrintSearchStatistics("Shortest", Planner->SearchStatistics());
+    Planner->ResetSearchStatistics();
+    for(auto &Pair : Pairs){
+        Planner->FindFastestPath(Pair.first, Pair.second, FastestPath);
+    }
+    PrintSearchStatistics("Fastest", Planner->SearchStatistics());
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include "StringDataSource.h"
+#include "DSVReader.h"
+#include "BusPathStore.h"
+
+TEST(BusPathStore, EmptyTest){
+    auto InStreamPaths = std::make_shared<CStringDataSource>("src_id,dest_id,routes,path");
+    auto CSVReaderPaths = std::make_shared<CDSVReader>(InStreamPaths,',');
+    CBusPathStore BusPaths(CSVReaderPaths);
+    std::vector<CBusPathStore::TNodeID> Path;
+    EXPECT_EQ(BusPaths.SegmentCount(),0);
+    EXPECT_EQ(BusPaths.PathNodeCount(),0);
+    EXPECT_FALSE(BusPaths.HasPath(1,2));
+    EXPECT_FALSE(BusPaths.GetPath(1,2,Path));
+    EXPECT_TRUE(Path.empty());
+}
+
+TEST(BusPathStore, PathTest){
+    auto InStreamPaths = std::make_shared<CStringDataSource>(   "src_id,dest_id,routes,path\n"
+                                                                "1,4,A_B,\"1,2,3,4\"\n"
+                                                                "4,5,B,\"4,5\"");
+    auto CSVReaderPaths = std::make_shared<CDSVReader>(InStreamPaths,',');
+    CBusPathStore BusPaths(CSVReaderPaths);
+    std::vector<CBusPathStore::TNodeID> Path, ExpectedPath1 = {1,2,3,4}, ExpectedPath2 = {4,5};
+    std::vector<std::string> ExpectedRoutes1 = {"A","B"}, ExpectedRoutes2 = {"B"};
+    EXPECT_EQ(BusPaths.SegmentCount(),2);
+    EXPECT_EQ(BusPaths.PathNodeCount(),6);
+    EXPECT_TRUE(BusPaths.HasPath(1,4));
+    EXPECT_FALSE(BusPaths.HasPath(4,1));
+    EXPECT_TRUE(BusPaths.GetPath(1,4,Path));
+    EXPECT_EQ(Path,ExpectedPath1);
+    EXPECT_TRUE(BusPaths.GetPath(4,5,Path));
+    EXPECT_EQ(Path,ExpectedPath2);
+    EXPECT_EQ(BusPaths.GetRoutes(1,4),ExpectedRoutes1);
+    EXPECT_EQ(BusPaths.GetRoutes(4,5),ExpectedRoutes2);
+    EXPECT_TRUE(BusPaths.GetRoutes(5,4).empty());
+}
+
+TEST(BusPathStore, InvalidRowTest){
+    auto InStreamPaths = std::make_shared<CStringDataSource>(   "src_id,dest_id,routes,path\n"
+                                                                "1,4,A,\"1,2,3\"\n"
+                                                                "2,3,A,\"2,x,3\"\n"
+                                                                "5,6,A\n"
+                                                                "7,8,C,\"7,8\"");
+    auto CSVReaderPaths = std::make_shared<CDSVReader>(InStreamPaths,',');
+    CBusPathStore BusPaths(CSVReaderPaths);
+    EXPECT_EQ(BusPaths.SegmentCount(),1);
+    EXPECT_EQ(BusPaths.PathNodeCount(),2);
+    EXPECT_FALSE(BusPaths.HasPath(1,4));
+    EXPECT_FALSE(BusPaths.HasPath(2,3));
+    EXPECT_FALSE(BusPaths.HasPath(5,6));
+    EXPECT_TRUE(BusPaths.HasPath(7,8));
+}
@@ -61,4 +61,47 @@ TEST(CSVBusSystem, RouteTest){
     EXPECT_EQ(Route1Index->GetStopID(0),1);
     EXPECT_EQ(Route1Index->GetStopID(1),2);
     EXPECT_EQ(Route1Index->GetStopID(2),1);
-}
\ No newline at end of file
+}
+TEST(CSVBusSystem, ArenaLifetimeTest){
+    auto InStreamStops = std::make_shared<CStringDataSource>(   "stop_id,node_id\n"
+                                                                "1,101\n"
+                                                                "2,102");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>(  "route,stop_id\n"
+                                                                "A route name that does not fit inline,1\n"
+                                                                "A route name that does not fit inline,2");
+    std::shared_ptr<CBusSystem::SStop> Stop;
+    std::shared_ptr<CBusSystem::SRoute> Route;
+    {
+        CCSVBusSystem BusSystem(std::make_shared<CDSVReader>(InStreamStops,','), std::make_shared<CDSVReader>(InStreamRoutes,','));
+        Stop = BusSystem.StopByID(2);
+        Route = BusSystem.RouteByName("A route name that does not fit inline");
+        EXPECT_EQ(Route,BusSystem.RouteByIndex(0));
+    }
+    ASSERT_TRUE(bool(Stop));
+    EXPECT_EQ(Stop->NodeID(),102);
+    ASSERT_TRUE(bool(Route));
+    EXPECT_EQ(Route->Name(),"A route name that does not fit inline");
+    EXPECT_EQ(Route->StopCount(),2);
+    EXPECT_EQ(Route->GetStopID(1),2);
+}
+
+TEST(CSVBusSystem, PointerAccessTest){
+    auto InStreamStops = std::make_shared<CStringDataSource>(   "stop_id,node_id\n"
+                                                                "1,101\n"
+                                                                "2,102");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>(  "route,stop_id\n"
+                                                                "A,1\n"
+                                                                "A,2");
+    CCSVBusSystem BusSystem(std::make_shared<CDSVReader>(InStreamStops,','), std::make_shared<CDSVReader>(InStreamRoutes,','));
+    ASSERT_NE(BusSystem.StopPtrByIndex(1),nullptr);
+    EXPECT_EQ(BusSystem.StopPtrByIndex(1),BusSystem.StopByIndex(1).get());
+    EXPECT_EQ(BusSystem.StopPtrByID(2),BusSystem.StopPtrByIndex(1));
+    EXPECT_EQ(BusSystem.StopPtrByIndex(2),nullptr);
+    EXPECT_EQ(BusSystem.StopPtrByID(3),nullptr);
+    ASSERT_NE(BusSystem.RoutePtrByName("A"),nullptr);
+    EXPECT_EQ(BusSystem.RoutePtrByName("A"),BusSystem.RoutePtrByIndex(0));
+    EXPECT_EQ(BusSystem.RoutePtrByName("A"),BusSystem.RouteByName("A").get());
+    EXPECT_EQ(BusSystem.RoutePtrByName("A")->StopCount(),2);
+    EXPECT_EQ(BusSystem.RoutePtrByIndex(1),nullptr);
+    EXPECT_EQ(BusSystem.RoutePtrByName("B"),nullptr);
+}
@@ -8,6 +8,80 @@
 #include "DijkstraTransportationPlanner.h"
 #include "GeographicUtils.h"
 
+// Ways 10 (1 -> 2 -> 3) and 11 (3 -> 4 -> 1) are oneway around a square
+// with no buses, args are the STransportationPlannerConfig parameters that
+// follow the bus system.
+// 6.9090909 mil 1 -> 2
+// 5.4 mile  2 -> 3
+// 6.9090909 mil 3 -> 4
+// 5.407386 mi 4 -> 1
+template <typename... TArgs>
+static std::shared_ptr<STransportationPlannerConfig> OnewaySquareConfig(TArgs... args){
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.6\" lon=\"-121.8\"/>"
+                                                            "<node id=\"4\" lat=\"38.5\" lon=\"-121.8\"/>"
+                                                            "<way id=\"10\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<tag k=\"oneway\" v=\"yes\"/>"
+                                                            "</way>"
+                                                            "<way id=\"11\">"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<nd ref=\"4\"/>"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<tag k=\"oneway\" v=\"yes\"/>"
+                                                            "</way>"
+                                                            "</osm>");
+    auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>("route,stop_id");
+    auto XMLReader = std::make_shared<CXMLReader>(InStreamOSM);
+    auto CSVReaderStops = std::make_shared<CDSVReader>(InStreamStops,',');
+    auto CSVReaderRoutes = std::make_shared<CDSVReader>(InStreamRoutes,',');
+    auto StreetMap = std::make_shared<COpenStreetMap>(XMLReader);
+    auto BusSystem = std::make_shared<CCSVBusSystem>(CSVReaderStops, CSVReaderRoutes);
+    return std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem,args...);
+}
+
+// Main Street (way 10) is oneway from 1 to 2 with an unnamed two way
+// street (way 11) beside it, way 12 closes the square 2 -> 3 -> 4 -> 1.
+static std::shared_ptr<STransportationPlannerConfig> ParallelWaysConfig(){
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.6\" lon=\"-121.8\"/>"
+                                                            "<node id=\"4\" lat=\"38.5\" lon=\"-121.8\"/>"
+                                                            "<way id=\"10\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<tag k=\"name\" v=\"Main Street\"/>"
+                                                            "<tag k=\"oneway\" v=\"yes\"/>"
+                                                            "</way>"
+                                                            "<way id=\"11\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "</way>"
+                                                            "<way id=\"12\">"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<nd ref=\"4\"/>"
+                                                            "<nd ref=\"1\"/>"
+                                                            "</way>"
+                                                            "</osm>");
+    auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>("route,stop_id");
+    auto XMLReader = std::make_shared<CXMLReader>(InStreamOSM);
+    auto CSVReaderStops = std::make_shared<CDSVReader>(InStreamStops,',');
+    auto CSVReaderRoutes = std::make_shared<CDSVReader>(InStreamRoutes,',');
+    auto StreetMap = std::make_shared<COpenStreetMap>(XMLReader);
+    auto BusSystem = std::make_shared<CCSVBusSystem>(CSVReaderStops, CSVReaderRoutes);
+    return std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem);
+}
+
 TEST(CSVOSMTransporationPlanner, SimpleTest){
     auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
                                                             "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
@@ -256,4 +330,437 @@ TEST(CSVOSMTransporationPlanner, PathDescription){
 
 }
 
- 
\ No newline at end of file
+ 
+TEST(CSVOSMTransporationPlanner, BusPathTest){
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.55\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.55\" lon=\"-121.75\"/>"
+                                                            "<node id=\"4\" lat=\"38.6\" lon=\"-121.75\"/>"
+                                                            "</osm>");
+    auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id\n"
+                                                            "101,1\n"
+                                                            "102,4");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>("route,stop_id\n"
+                                                             "A,101\n"
+                                                             "A,102");
+    auto InStreamPaths = std::make_shared<CStringDataSource>("src_id,dest_id,routes,path\n"
+                                                            "1,4,A,\"1,2,3,4\"");
+    auto XMLReader = std::make_shared<CXMLReader>(InStreamOSM);
+    auto CSVReaderStops = std::make_shared<CDSVReader>(InStreamStops,',');
+    auto CSVReaderRoutes = std::make_shared<CDSVReader>(InStreamRoutes,',');
+    auto CSVReaderPaths = std::make_shared<CDSVReader>(InStreamPaths,',');
+    auto StreetMap = std::make_shared<COpenStreetMap>(XMLReader);
+    auto BusSystem = std::make_shared<CCSVBusSystem>(CSVReaderStops, CSVReaderRoutes);
+    auto BusPaths = std::make_shared<CBusPathStore>(CSVReaderPaths);
+    auto Config = std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem,3.0,8.0,25.0,30.0,30,BusPaths);
+    CDijkstraTransportationPlanner Planner(Config);
+    std::vector< CTransportationPlanner::TTripStep > FastestPath, ExpectedFastestPath = {{CTransportationPlanner::ETransportationMode::Walk,1},
+                                                                                        {CTransportationPlanner::ETransportationMode::Bus,2},
+                                                                                        {CTransportationPlanner::ETransportationMode::Bus,3},
+                                                                                        {CTransportationPlanner::ETransportationMode::Bus,4}};
+    double ExpectedDistance = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.5,-121.7),std::make_pair(38.55,-121.7)) + 
+                                SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.55,-121.7),std::make_pair(38.55,-121.75)) + 
+                                SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.55,-121.75),std::make_pair(38.6,-121.75));
+    EXPECT_DOUBLE_EQ(Planner.FindFastestPath(1,4,FastestPath),ExpectedDistance / 25.0 + 30.0 / 3600.0);
+    EXPECT_EQ(FastestPath,ExpectedFastestPath);
+}
+
+TEST(CSVOSMTransporationPlanner, PathWaysTest){
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.6\" lon=\"-121.8\"/>"
+                                                            "<node id=\"4\" lat=\"38.5\" lon=\"-121.8\"/>"
+                                                            "<way id=\"10\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<tag k=\"name\" v=\"A St.\"/>"
+                                                            "<tag k=\"highway\" v=\"residential\"/>"
+                                                            "<tag k=\"maxspeed\" v=\"20 mph\"/>"
+                                                            "</way>"
+                                                            "<way id=\"11\">"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<nd ref=\"4\"/>"
+                                                            "</way>"
+                                                            "</osm>");
+    auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>("route,stop_id");
+    auto XMLReader = std::make_shared<CXMLReader>(InStreamOSM);
+    auto CSVReaderStops = std::make_shared<CDSVReader>(InStreamStops,',');
+    auto CSVReaderRoutes = std::make_shared<CDSVReader>(InStreamRoutes,',');
+    auto StreetMap = std::make_shared<COpenStreetMap>(XMLReader);
+    auto BusSystem = std::make_shared<CCSVBusSystem>(CSVReaderStops, CSVReaderRoutes);
+    auto Config = std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem);
+    CDijkstraTransportationPlanner Planner(Config);
+    std::vector< CStreetMap::TWayID > Ways, ExpectedWays = {10,10,11};
+    EXPECT_TRUE(Planner.GetPathWays({1,2,3,4},Ways));
+    EXPECT_EQ(Ways,ExpectedWays);
+    ExpectedWays = {11,10};
+    EXPECT_TRUE(Planner.GetPathWays({4,3,2},Ways));
+    EXPECT_EQ(Ways,ExpectedWays);
+    ExpectedWays = {CStreetMap::InvalidWayID};
+    EXPECT_FALSE(Planner.GetPathWays({1,3},Ways));
+    EXPECT_EQ(Ways,ExpectedWays);
+    EXPECT_FALSE(Planner.GetPathWays({1,5},Ways));
+
+    std::vector< CTransportationPlanner::SWayInfo > Info;
+    EXPECT_TRUE(Planner.GetPathWayInfo({2,3,4},Info));
+    ASSERT_EQ(Info.size(),2);
+    EXPECT_EQ(Info[0].DWayID,10);
+    EXPECT_EQ(Info[0].DName,"A St.");
+    EXPECT_EQ(Info[0].DMaxSpeed,"20 mph");
+    EXPECT_EQ(Info[0].DHighway,"residential");
+    EXPECT_EQ(Info[1].DWayID,11);
+    EXPECT_EQ(Info[1].DName,"");
+    EXPECT_EQ(Info[1].DMaxSpeed,"");
+    EXPECT_EQ(Info[1].DHighway,"");
+}
+
+TEST(CSVOSMTransporationPlanner, PathCacheTest){
+    auto Config = OnewaySquareConfig(3.0,8.0,25.0,30.0,30,nullptr,16);
+    CDijkstraTransportationPlanner Planner(Config);
+    Planner.SetSearchStatisticsEnabled(true);
+    std::vector< CTransportationPlanner::TNodeID > ShortestPath, ExpectedShortestPath = {1,2,3,4};
+    double ExpectedDistance = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.5,-121.7),std::make_pair(38.6,-121.7)) + 
+                                SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.6,-121.7),std::make_pair(38.6,-121.8)) + 
+                                SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.6,-121.8),std::make_pair(38.5,-121.8));
+    EXPECT_EQ(Planner.FindShortestPath(1,4,ShortestPath),ExpectedDistance);
+    EXPECT_EQ(ShortestPath,ExpectedShortestPath);
+    EXPECT_EQ(Planner.SearchStatistics().DSearches,1);
+    EXPECT_EQ(Planner.SearchStatistics().DSettledVertices,4);
+    // Cache hits never reach the routers
+    EXPECT_EQ(Planner.FindShortestPath(1,4,ShortestPath),ExpectedDistance);
+    EXPECT_EQ(ShortestPath,ExpectedShortestPath);
+    EXPECT_EQ(Planner.SearchStatistics().DSearches,1);
+    auto Statistics = Planner.PathCacheStatistics();
+    EXPECT_EQ(Statistics.DHits,1);
+    EXPECT_EQ(Statistics.DMisses,1);
+    EXPECT_EQ(Statistics.DEntries,1);
+    Planner.ClearPathCache();
+    EXPECT_EQ(Planner.FindShortestPath(1,4,ShortestPath),ExpectedDistance);
+    EXPECT_EQ(Planner.PathCacheStatistics().DMisses,2);
+}
+
+TEST(CSVOSMTransporationPlanner, PathCacheInvalidationTest){
+    CDijkstraTransportationPlanner Planner(OnewaySquareConfig(3.0,8.0,25.0,30.0,30,nullptr,16));
+    std::vector< CTransportationPlanner::TNodeID > ShortestPath, ExpectedShortestPath = {1,2,3,4};
+    double ExpectedDistance = Planner.FindShortestPath(1,4,ShortestPath);
+    EXPECT_EQ(ShortestPath,ExpectedShortestPath);
+    EXPECT_EQ(Planner.FindShortestPath(1,4,ShortestPath),ExpectedDistance);
+    EXPECT_EQ(Planner.PathCacheStatistics().DHits,1);
+    // A shortcut added to the router must not be hidden by the cached path
+    auto Router = Planner.DistanceRouter();
+    CPathRouter::TVertexID Vertex1 = CPathRouter::InvalidVertexID, Vertex4 = CPathRouter::InvalidVertexID;
+    for(std::size_t Index = 0; Index < Router->VertexCount(); Index++){
+        auto NodeID = std::any_cast<CTransportationPlanner::TNodeID>(Router->GetVertexTag(Index));
+        if(NodeID == 1){
+            Vertex1 = Index;
+        }
+        else if(NodeID == 4){
+            Vertex4 = Index;
+        }
+    }
+    ASSERT_TRUE(Router->AddEdge(Vertex1,Vertex4,1.0));
+    ExpectedShortestPath = {1,4};
+    EXPECT_EQ(Planner.FindShortestPath(1,4,ShortestPath),1.0);
+    EXPECT_EQ(ShortestPath,ExpectedShortestPath);
+    auto Statistics = Planner.PathCacheStatistics();
+    EXPECT_EQ(Statistics.DHits,1);
+    EXPECT_EQ(Statistics.DMisses,2);
+    EXPECT_EQ(Statistics.DInvalidations,1);
+    EXPECT_EQ(Statistics.DEntries,1);
+    EXPECT_EQ(Planner.FindShortestPath(1,4,ShortestPath),1.0);
+    EXPECT_EQ(Planner.PathCacheStatistics().DHits,2);
+}
+
+TEST(CSVOSMTransporationPlanner, ConstructionReportTest){
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.6\" lon=\"-121.8\"><tag k=\"highway\" v=\"traffic_signals\"/></node>"
+                                                            "<way id=\"10\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<tag k=\"name\" v=\"A Street\"/>"
+                                                            "<tag k=\"oneway\" v=\"yes\"/>"
+                                                            "</way>"
+                                                            "</osm>");
+    auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id\n1,1\n2,3");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>("route,stop_id\nA,1\nA,2");
+    auto StreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(InStreamOSM));
+    auto BusSystem = std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(InStreamStops,','), std::make_shared<CDSVReader>(InStreamRoutes,','));
+    CDijkstraTransportationPlanner Planner(std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem));
+
+    std::vector< SConstructionReport > Reports;
+    ASSERT_TRUE(Planner.ConstructionReports(Reports));
+    ASSERT_EQ(Reports.size(),3);
+    EXPECT_EQ(Reports[0].DName,"COpenStreetMap");
+    EXPECT_EQ(Reports[1].DName,"CCSVBusSystem");
+    EXPECT_EQ(Reports[2].DName,"CDijkstraTransportationPlanner");
+    auto Component = [](const SConstructionReport &report, const std::string &name){
+        for(auto &Component : report.DComponents){
+            if(Component.DName == name){
+                return Component;
+            }
+        }
+        return SConstructionReport::SComponent{name,0,0};
+    };
+    EXPECT_EQ(Component(Reports[0],"nodes").DCount,3);
+    EXPECT_EQ(Component(Reports[0],"node tags").DCount,1);
+    EXPECT_EQ(Component(Reports[0],"way node refs").DCount,3);
+    EXPECT_EQ(Component(Reports[0],"way tags").DCount,2);
+    EXPECT_EQ(Component(Reports[1],"stops").DCount,2);
+    EXPECT_EQ(Component(Reports[1],"route stops").DCount,2);
+    EXPECT_EQ(Component(Reports[2],"street edges").DCount,4);
+    EXPECT_EQ(Component(Reports[2],"distance router edges").DCount,2);
+    EXPECT_GT(Component(Reports[2],"street edges").DBytes,0);
+    for(auto &Report : Reports){
+        EXPECT_GT(Report.TotalBytes(),0);
+        EXPECT_FALSE(Report.DPhases.empty());
+    }
+    // The hierarchy waits for the first travel time trees
+    EXPECT_EQ(Reports[2].DPhases.back().DName,"time graph");
+    EXPECT_EQ(Component(Reports[2],"time router hierarchy edges").DCount,0);
+    std::vector< std::vector< double > > Times;
+    EXPECT_TRUE(Planner.FindTravelTimeTrees({1},Times));
+    ASSERT_TRUE(Planner.ConstructionReports(Reports));
+    EXPECT_GT(Component(Reports[2],"time router hierarchy edges").DCount,0);
+}
+
+TEST(CSVOSMTransporationPlanner, IsochroneTest){
+    auto Config = OnewaySquareConfig();
+    CDijkstraTransportationPlanner Planner(Config);
+    std::vector< std::pair< CTransportationPlanner::TNodeID, double > > Reached;
+    EXPECT_TRUE(Planner.FindIsochrone(1,0.0,Reached));
+    ASSERT_EQ(Reached.size(),1);
+    EXPECT_EQ(Reached[0].first,1);
+    EXPECT_EQ(Reached[0].second,0.0);
+    EXPECT_TRUE(Planner.FindIsochrone(1,100.0,Reached));
+    // Walking ignores the oneway tags, 4 is the nearest neighbor of 1
+    std::vector< CTransportationPlanner::TNodeID > ExpectedOrder = {1,4,2,3};
+    ASSERT_EQ(Reached.size(),4);
+    for(std::size_t Index = 0; Index < Reached.size(); Index++){
+        EXPECT_EQ(Reached[Index].first,ExpectedOrder[Index]);
+    }
+    EXPECT_DOUBLE_EQ(Reached[1].second,SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.5,-121.7),std::make_pair(38.5,-121.8)) / 3.0);
+    EXPECT_TRUE(Planner.FindIsochrone(1,Reached[2].second,Reached));
+    EXPECT_EQ(Reached.size(),3);
+    EXPECT_FALSE(Planner.FindIsochrone(5,1.0,Reached));
+    EXPECT_TRUE(Reached.empty());
+}
+
+TEST(CSVOSMTransporationPlanner, TravelTimeTreesTest){
+    auto Config = OnewaySquareConfig();
+    CDijkstraTransportationPlanner Planner(Config);
+    std::vector< std::vector< double > > Times;
+    std::vector< std::pair< CTransportationPlanner::TNodeID, double > > Reached;
+    EXPECT_TRUE(Planner.FindTravelTimeTrees({1,3},Times));
+    ASSERT_EQ(Times.size(),2);
+    for(std::size_t Source = 0; Source < Times.size(); Source++){
+        ASSERT_EQ(Times[Source].size(),Planner.NodeCount());
+        EXPECT_TRUE(Planner.FindIsochrone(Source ? 3 : 1,100.0,Reached));
+        ASSERT_EQ(Reached.size(),4);
+        for(auto &Node : Reached){
+            EXPECT_NEAR(Times[Source][Node.first - 1],Node.second,1e-9);
+        }
+    }
+    EXPECT_EQ(Times[1][2],0.0);
+    EXPECT_FALSE(Planner.FindTravelTimeTrees({1,5},Times));
+}
+
+TEST(CSVOSMTransporationPlanner, FixedPointShortestPathTest){
+    auto Config = OnewaySquareConfig(3.0,8.0,25.0,30.0,30,nullptr,0,160934.4);
+    CDijkstraTransportationPlanner Planner(Config);
+    std::vector< CTransportationPlanner::TNodeID > ShortestPath, ExpectedShortestPath = {1,2,3,4};
+    double ExpectedDistance = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.5,-121.7),std::make_pair(38.6,-121.7)) + 
+                                SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.6,-121.7),std::make_pair(38.6,-121.8)) + 
+                                SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.6,-121.8),std::make_pair(38.5,-121.8));
+    EXPECT_EQ(Planner.FindShortestPath(1,4,ShortestPath),ExpectedDistance);
+    EXPECT_EQ(ShortestPath,ExpectedShortestPath);
+}
+
+TEST(CSVOSMTransporationPlanner, HilbertOrderTest){
+    auto Config = OnewaySquareConfig(3.0,8.0,25.0,30.0,30,nullptr,0,0.0,CTransportationPlanner::EVertexOrder::Hilbert);
+    CDijkstraTransportationPlanner Planner(Config);
+    std::vector< CTransportationPlanner::TNodeID > ShortestPath, ExpectedShortestPath = {1,2,3,4};
+    double ExpectedDistance = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.5,-121.7),std::make_pair(38.6,-121.7)) + 
+                                SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.6,-121.7),std::make_pair(38.6,-121.8)) + 
+                                SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.6,-121.8),std::make_pair(38.5,-121.8));
+    EXPECT_EQ(Planner.FindShortestPath(1,4,ShortestPath),ExpectedDistance);
+    EXPECT_EQ(ShortestPath,ExpectedShortestPath);
+    ASSERT_EQ(Planner.NodeCount(),4);
+    for(std::size_t Index = 0; Index < Planner.NodeCount(); Index++){
+        EXPECT_EQ(Planner.SortedNodeByIndex(Index)->ID(),Index + 1);
+        EXPECT_EQ(Planner.SortedNodePtrByIndex(Index),Planner.SortedNodeByIndex(Index).get());
+    }
+    EXPECT_EQ(Planner.SortedNodePtrByIndex(Planner.NodeCount()),nullptr);
+}
+
+TEST(CSVOSMTransporationPlanner, OnewayFastestPathTest){
+    auto Config = OnewaySquareConfig();
+    CDijkstraTransportationPlanner Planner(Config);
+    // Cycling 1 -> 4 has to follow the oneway loop, walking does not
+    std::vector< CTransportationPlanner::TTripStep > FastestPath, ExpectedFastestPath = {{CTransportationPlanner::ETransportationMode::Walk,1},
+                                                                                        {CTransportationPlanner::ETransportationMode::Walk,4}};
+    double ExpectedTime = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.5,-121.7),std::make_pair(38.5,-121.8)) / 3.0;
+    EXPECT_EQ(Planner.FindFastestPath(1,4,FastestPath),ExpectedTime);
+    EXPECT_EQ(FastestPath,ExpectedFastestPath);
+    ExpectedFastestPath = {{CTransportationPlanner::ETransportationMode::Bike,4},
+                           {CTransportationPlanner::ETransportationMode::Bike,1}};
+    ExpectedTime = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.5,-121.8),std::make_pair(38.5,-121.7)) / 8.0;
+    EXPECT_EQ(Planner.FindFastestPath(4,1,FastestPath),ExpectedTime);
+    EXPECT_EQ(FastestPath,ExpectedFastestPath);
+}
+
+TEST(CSVOSMTransporationPlanner, ProfilePathTest){
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.6\" lon=\"-121.8\"/>"
+                                                            "<way id=\"10\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<tag k=\"oneway\" v=\"yes\"/>"
+                                                            "<tag k=\"maxspeed\" v=\"30 mph\"/>"
+                                                            "</way>"
+                                                            "<way id=\"11\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<tag k=\"highway\" v=\"steps\"/>"
+                                                            "</way>"
+                                                            "</osm>");
+    auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>("route,stop_id");
+    auto XMLReader = std::make_shared<CXMLReader>(InStreamOSM);
+    auto CSVReaderStops = std::make_shared<CDSVReader>(InStreamStops,',');
+    auto CSVReaderRoutes = std::make_shared<CDSVReader>(InStreamRoutes,',');
+    auto StreetMap = std::make_shared<COpenStreetMap>(XMLReader);
+    auto BusSystem = std::make_shared<CCSVBusSystem>(CSVReaderStops, CSVReaderRoutes);
+    auto Config = std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem);
+    CDijkstraTransportationPlanner Planner(Config);
+    double Distance12 = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.5,-121.7),std::make_pair(38.6,-121.7));
+    double Distance23 = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.6,-121.7),std::make_pair(38.6,-121.8));
+    double Distance13 = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.5,-121.7),std::make_pair(38.6,-121.8));
+    std::vector< CTransportationPlanner::TNodeID > Path, ExpectedPath = {1,3};
+    // Walkers take the steps, wheelchairs and cars have to go around
+    EXPECT_DOUBLE_EQ(Planner.FindProfilePath(CTransportationPlanner::ERoutingProfile::Pedestrian,1,3,Path),Distance13 / 3.0);
+    EXPECT_EQ(Path,ExpectedPath);
+    ExpectedPath = {1,2,3};
+    EXPECT_DOUBLE_EQ(Planner.FindProfilePath(CTransportationPlanner::ERoutingProfile::Wheelchair,1,3,Path),(Distance12 + Distance23) / 3.0);
+    EXPECT_EQ(Path,ExpectedPath);
+    EXPECT_DOUBLE_EQ(Planner.FindProfilePath(CTransportationPlanner::ERoutingProfile::Car,1,3,Path),(Distance12 + Distance23) / 30.0);
+    EXPECT_EQ(Path,ExpectedPath);
+    EXPECT_EQ(Planner.FindProfilePath(CTransportationPlanner::ERoutingProfile::Car,3,1,Path),CPathRouter::NoPathExists);
+    EXPECT_TRUE(Path.empty());
+    ExpectedPath = {3,1};
+    EXPECT_DOUBLE_EQ(Planner.FindProfilePath(CTransportationPlanner::ERoutingProfile::Pedestrian,3,1,Path),Distance13 / 3.0);
+    EXPECT_EQ(Path,ExpectedPath);
+    EXPECT_EQ(Planner.FindProfilePath(CTransportationPlanner::ERoutingProfile::Bicycle,1,5,Path),CPathRouter::NoPathExists);
+}
+
+TEST(CSVOSMTransporationPlanner, ParallelWaysProfilePathTest){
+    CDijkstraTransportationPlanner Planner(ParallelWaysConfig());
+    double Distance12 = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.5,-121.7),std::make_pair(38.6,-121.7));
+    std::vector< CTransportationPlanner::TNodeID > Path, ExpectedPath = {2,1};
+    // Main Street is oneway but the street beside it is not
+    EXPECT_DOUBLE_EQ(Planner.FindProfilePath(CTransportationPlanner::ERoutingProfile::Bicycle,2,1,Path),Distance12 / 8.0);
+    EXPECT_EQ(Path,ExpectedPath);
+    EXPECT_DOUBLE_EQ(Planner.FindProfilePath(CTransportationPlanner::ERoutingProfile::Car,2,1,Path),Distance12 / 25.0);
+    EXPECT_EQ(Path,ExpectedPath);
+    // Names still come from the named way in either direction
+    std::vector< CStreetMap::TWayID > Ways, ExpectedWays = {10};
+    EXPECT_TRUE(Planner.GetPathWays({1,2},Ways));
+    EXPECT_EQ(Ways,ExpectedWays);
+    EXPECT_TRUE(Planner.GetPathWays({2,1},Ways));
+    EXPECT_EQ(Ways,ExpectedWays);
+}
+
+TEST(CSVOSMTransporationPlanner, LocationPathTest){
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.6\" lon=\"-121.8\"/>"
+                                                            "<node id=\"4\" lat=\"38.5\" lon=\"-121.8\"/>"
+                                                            "<node id=\"5\" lat=\"38.55\" lon=\"-121.75\"/>"
+                                                            "<way id=\"10\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<tag k=\"oneway\" v=\"yes\"/>"
+                                                            "</way>"
+                                                            "<way id=\"11\">"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<nd ref=\"4\"/>"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<tag k=\"oneway\" v=\"yes\"/>"
+                                                            "</way>"
+                                                            "</osm>");
+    auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>("route,stop_id");
+    auto XMLReader = std::make_shared<CXMLReader>(InStreamOSM);
+    auto CSVReaderStops = std::make_shared<CDSVReader>(InStreamStops,',');
+    auto CSVReaderRoutes = std::make_shared<CDSVReader>(InStreamRoutes,',');
+    auto StreetMap = std::make_shared<COpenStreetMap>(XMLReader);
+    auto BusSystem = std::make_shared<CCSVBusSystem>(CSVReaderStops, CSVReaderRoutes);
+    auto Config = std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem);
+    CDijkstraTransportationPlanner Planner(Config);
+    // Node 5 is on no way so locations never snap to it
+    EXPECT_EQ(Planner.SpatialIndex().NodeCount(),4);
+    EXPECT_EQ(Planner.NearestNode({38.56,-121.74}),2);
+    EXPECT_EQ(Planner.NearestNode({38.51,-121.71}),1);
+    // Locations snap onto the closest point of a road, the partial roads at
+    // either end count towards the cost
+    std::vector< CTransportationPlanner::TNodeID > ShortestPath, ExpectedShortestPath = {2};
+    double ExpectedDistance = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.51,-121.7),std::make_pair(38.6,-121.7)) +
+                                SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.6,-121.7),std::make_pair(38.6,-121.75));
+    EXPECT_NEAR(Planner.FindShortestPathBetweenLocations({38.51,-121.69},{38.61,-121.75},ShortestPath),ExpectedDistance,1e-6);
+    EXPECT_EQ(ShortestPath,ExpectedShortestPath);
+    ExpectedShortestPath = {3,4,1};
+    EXPECT_GT(Planner.FindShortestPathBetweenLocations({38.61,-121.75},{38.51,-121.69},ShortestPath),ExpectedDistance);
+    EXPECT_EQ(ShortestPath,ExpectedShortestPath);
+    // Along one edge the way the street runs no node is passed, against it
+    // the oneway loop has to be driven
+    ExpectedDistance = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.52,-121.7),std::make_pair(38.55,-121.7));
+    EXPECT_NEAR(Planner.FindShortestPathBetweenLocations({38.52,-121.7},{38.55,-121.7},ShortestPath),ExpectedDistance,1e-6);
+    EXPECT_TRUE(ShortestPath.empty());
+    ExpectedShortestPath = {2,3,4,1};
+    EXPECT_GT(Planner.FindShortestPathBetweenLocations({38.55,-121.7},{38.52,-121.7},ShortestPath),ExpectedDistance);
+    EXPECT_EQ(ShortestPath,ExpectedShortestPath);
+    // Walking may go against the oneway street
+    std::vector< CTransportationPlanner::TTripStep > FastestPath;
+    EXPECT_NEAR(Planner.FindFastestPathBetweenLocations({38.55,-121.7},{38.52,-121.7},FastestPath),ExpectedDistance / 3.0,1e-6);
+    EXPECT_TRUE(FastestPath.empty());
+    std::vector< CTransportationPlanner::TTripStep > ExpectedFastestPath = {{CTransportationPlanner::ETransportationMode::Bike,2}};
+    ExpectedDistance = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.55,-121.7),std::make_pair(38.6,-121.7)) +
+                        SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.6,-121.7),std::make_pair(38.6,-121.75));
+    EXPECT_NEAR(Planner.FindFastestPathBetweenLocations({38.55,-121.7},{38.6,-121.75},FastestPath),ExpectedDistance / 8.0,1e-6);
+    EXPECT_EQ(FastestPath,ExpectedFastestPath);
+}
+
+TEST(CSVOSMTransporationPlanner, ParallelWaysLocationPathTest){
+    CDijkstraTransportationPlanner Planner(ParallelWaysConfig());
+    // Against Main Street the unnamed street beside it may be taken
+    std::vector< CTransportationPlanner::TNodeID > ShortestPath, ExpectedShortestPath = {1};
+    double ExpectedDistance = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.55,-121.7),std::make_pair(38.5,-121.7)) +
+                                SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.5,-121.7),std::make_pair(38.5,-121.75));
+    EXPECT_NEAR(Planner.FindShortestPathBetweenLocations({38.55,-121.7},{38.5,-121.75},ShortestPath),ExpectedDistance,1e-6);
+    EXPECT_EQ(ShortestPath,ExpectedShortestPath);
+    std::vector< CTransportationPlanner::TTripStep > FastestPath, ExpectedFastestPath = {{CTransportationPlanner::ETransportationMode::Bike,1}};
+    EXPECT_NEAR(Planner.FindFastestPathBetweenLocations({38.55,-121.7},{38.5,-121.75},FastestPath),ExpectedDistance / 8.0,1e-6);
+    EXPECT_EQ(FastestPath,ExpectedFastestPath);
+    // Without reaching either end of the segment
+    ExpectedDistance = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.55,-121.7),std::make_pair(38.52,-121.7));
+    EXPECT_NEAR(Planner.FindShortestPathBetweenLocations({38.55,-121.7},{38.52,-121.7},ShortestPath),ExpectedDistance,1e-6);
+    EXPECT_TRUE(ShortestPath.empty());
+    EXPECT_NEAR(Planner.FindFastestPathBetweenLocations({38.55,-121.7},{38.52,-121.7},FastestPath),ExpectedDistance / 8.0,1e-6);
+    EXPECT_TRUE(FastestPath.empty());
+}
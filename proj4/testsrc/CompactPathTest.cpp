@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+#include "CompactPath.h"
+#include <limits>
+
+TEST(CompactPath, CodecTest){
+    std::vector<CCompactPath::TNodeID> Path = {10,9,8000000000ULL,7,0,std::numeric_limits<CCompactPath::TNodeID>::max(),1}, Decoded;
+    CCompactPath Compact(Path);
+    EXPECT_EQ(Compact.NodeCount(),Path.size());
+    EXPECT_FALSE(Compact.Empty());
+    EXPECT_TRUE(Compact.Decode(Decoded));
+    EXPECT_EQ(Decoded,Path);
+    EXPECT_EQ(Compact,CCompactPath(Path));
+    Compact.Encode({});
+    EXPECT_TRUE(Compact.Empty());
+    EXPECT_EQ(Compact.ByteCount(),0);
+    EXPECT_TRUE(Compact.Decode(Decoded));
+    EXPECT_TRUE(Decoded.empty());
+}
+
+TEST(CompactPath, SizeTest){
+    // Neighbouring IDs take one byte each, the first ID pays for its size
+    std::vector<CCompactPath::TNodeID> Path, Decoded;
+    for(CCompactPath::TNodeID NodeID = 5000000000ULL; NodeID < 5000001000ULL; NodeID += 3){
+        Path.push_back(NodeID);
+    }
+    CCompactPath Compact(Path);
+    EXPECT_EQ(Compact.ByteCount(),Path.size() - 1 + 5);
+    EXPECT_TRUE(Compact.Decode(Decoded));
+    EXPECT_EQ(Decoded,Path);
+}
+
+TEST(CompactPath, VarintTest){
+    std::vector<std::uint8_t> Encoded;
+    CCompactPath::WriteVarint(300,Encoded);
+    EXPECT_EQ(Encoded,std::vector<std::uint8_t>({0xAC,0x02}));
+    std::size_t Index = 0;
+    std::uint64_t Value;
+    EXPECT_TRUE(CCompactPath::ReadVarint(Encoded,Index,Value));
+    EXPECT_EQ(Value,300);
+    EXPECT_EQ(Index,2);
+    Encoded = {0x84};
+    Index = 0;
+    EXPECT_FALSE(CCompactPath::ReadVarint(Encoded,Index,Value));
+}
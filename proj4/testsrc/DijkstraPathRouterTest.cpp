@@ -3,6 +3,8 @@
 #include <chrono>
 #include <string>
 #include <vector>
+#include <memory>
+#include <thread>
 
 class DijkstraPathRouterTest : public ::testing::Test {
 protected:
@@ -179,10 +181,262 @@ TEST_F(DijkstraPathRouterTest, ComplexGraph) {
     EXPECT_EQ(v4, path[3]);
 }
 
+// Test one-to-all search with and without a cost bound
+TEST_F(DijkstraPathRouterTest, ShortestPathTree) {
+    auto vA = router.AddVertex("A");
+    auto vB = router.AddVertex("B");
+    auto vC = router.AddVertex("C");
+    auto vD = router.AddVertex("D");
+    auto vE = router.AddVertex("E");
+
+    router.AddEdge(vA, vB, 4.0);
+    router.AddEdge(vA, vC, 1.0);
+    router.AddEdge(vC, vB, 2.0);
+    router.AddEdge(vB, vD, 5.0);
+
+    std::vector<double> dist;
+    std::vector<CPathRouter::TVertexID> prev;
+    EXPECT_TRUE(router.FindShortestPathTree(vA, dist, prev));
+    ASSERT_EQ(5, dist.size());
+    EXPECT_EQ(0.0, dist[vA]);
+    EXPECT_EQ(3.0, dist[vB]);
+    EXPECT_EQ(1.0, dist[vC]);
+    EXPECT_EQ(8.0, dist[vD]);
+    EXPECT_EQ(CPathRouter::NoPathExists, dist[vE]);
+    EXPECT_EQ(vC, prev[vB]);
+    EXPECT_EQ(CPathRouter::InvalidVertexID, prev[vA]);
+
+    EXPECT_TRUE(router.FindShortestPathTree(vA, dist, prev, 3.0));
+    EXPECT_EQ(3.0, dist[vB]);
+    EXPECT_EQ(CPathRouter::NoPathExists, dist[vD]);
+
+    std::vector<std::pair<CPathRouter::TVertexID, double>> reached;
+    EXPECT_EQ(3, router.FindVerticesWithinCost(vA, 3.0, reached));
+    EXPECT_EQ(vA, reached[0].first);
+    EXPECT_EQ(vC, reached[1].first);
+    EXPECT_EQ(vB, reached[2].first);
+
+    EXPECT_FALSE(router.FindShortestPathTree(100, dist, prev));
+}
+
+// Test that hierarchy based trees match plain searches on a grid with
+// shortcuts and one way streets
+TEST_F(DijkstraPathRouterTest, ShortestPathTrees) {
+    const std::size_t Width = 12;
+    for (std::size_t i = 0; i < Width * Width; ++i)
+        router.AddVertex(i);
+    unsigned seed = 7;
+    auto nextWeight = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return 1.0 + double((seed >> 8) % 1000) / 100.0;
+    };
+    for (std::size_t row = 0; row < Width; ++row) {
+        for (std::size_t col = 0; col < Width; ++col) {
+            std::size_t v = row * Width + col;
+            if (col + 1 < Width)
+                router.AddEdge(v, v + 1, nextWeight(), row % 3 != 0);
+            if (row + 1 < Width)
+                router.AddEdge(v, v + Width, nextWeight(), col % 4 != 1);
+            if (row + 1 < Width && col + 1 < Width && (v % 5) == 0)
+                router.AddEdge(v, v + Width + 1, nextWeight());
+        }
+    }
+    std::vector<CPathRouter::TVertexID> sources = {0, 5, 17, 64, 99, 143};
+    std::vector<std::vector<double>> expected(sources.size());
+    std::vector<CPathRouter::TVertexID> prev;
+    for (std::size_t i = 0; i < sources.size(); ++i)
+        EXPECT_TRUE(router.FindShortestPathTree(sources[i], expected[i], prev));
+
+    EXPECT_FALSE(router.HasHierarchy());
+    EXPECT_TRUE(router.Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(10)));
+    EXPECT_TRUE(router.HasHierarchy());
+    std::vector<std::vector<double>> dist;
+    EXPECT_TRUE(router.FindShortestPathTrees(sources, dist));
+    ASSERT_EQ(sources.size(), dist.size());
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+        ASSERT_EQ(expected[i].size(), dist[i].size());
+        for (std::size_t v = 0; v < dist[i].size(); ++v) {
+            if (expected[i][v] == CPathRouter::NoPathExists)
+                EXPECT_EQ(CPathRouter::NoPathExists, dist[i][v]);
+            else
+                EXPECT_NEAR(expected[i][v], dist[i][v], 1e-9);
+        }
+    }
+
+    // Modifying the graph retires the hierarchy
+    router.AddEdge(0, Width * Width - 1, 1.0);
+    EXPECT_FALSE(router.HasHierarchy());
+    EXPECT_TRUE(router.FindShortestPathTrees({0}, dist));
+    EXPECT_EQ(1.0, dist[0][Width * Width - 1]);
+    EXPECT_FALSE(router.FindShortestPathTrees({Width * Width}, dist));
+}
+
+// Test that every queue type, with and without fixed point weights, finds
+// paths of the same cost
+TEST_F(DijkstraPathRouterTest, QueueTypes) {
+    const std::size_t Width = 10;
+    unsigned seed = 11;
+    auto nextWeight = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return 0.5 + double((seed >> 8) % 10000) / 1000.0;
+    };
+    std::vector<std::unique_ptr<CDijkstraPathRouter>> routers;
+    for (auto queue : {CDijkstraPathRouter::EQueueType::BinaryHeap, CDijkstraPathRouter::EQueueType::QuaternaryHeap, CDijkstraPathRouter::EQueueType::RadixHeap}) {
+        for (double scale : {0.0, 1e6}) {
+            routers.push_back(std::make_unique<CDijkstraPathRouter>(queue));
+            EXPECT_TRUE(routers.back()->SetFixedPointScale(scale));
+            EXPECT_EQ(queue, routers.back()->QueueType());
+        }
+    }
+    for (auto &r : routers) {
+        for (std::size_t i = 0; i < Width * Width; ++i)
+            r->AddVertex(i);
+    }
+    for (std::size_t v = 0; v < Width * Width; ++v) {
+        double right = nextWeight(), down = nextWeight();
+        for (auto &r : routers) {
+            if ((v % Width) + 1 < Width)
+                r->AddEdge(v, v + 1, right, v % 7 != 0);
+            if (v + Width < Width * Width)
+                r->AddEdge(v, v + Width, down, true);
+        }
+    }
+    for (auto [src, dest] : std::vector<std::pair<std::size_t, std::size_t>>{{0, 99}, {99, 0}, {45, 3}, {12, 87}, {50, 50}}) {
+        std::vector<CPathRouter::TVertexID> expectedPath;
+        double expected = routers[0]->FindShortestPath(src, dest, expectedPath);
+        EXPECT_NE(CPathRouter::NoPathExists, expected);
+        for (auto &r : routers) {
+            std::vector<CPathRouter::TVertexID> path;
+            double cost = r->FindShortestPath(src, dest, path);
+            EXPECT_NEAR(expected, cost, 1e-5);
+            EXPECT_EQ(expectedPath.front(), path.front());
+            EXPECT_EQ(expectedPath.back(), path.back());
+        }
+    }
+    EXPECT_FALSE(routers[0]->SetFixedPointScale(-1.0));
+}
+
+// Test that fixed point searches still return the exact path cost
+TEST_F(DijkstraPathRouterTest, FixedPointCost) {
+    auto vA = router.AddVertex("A");
+    auto vB = router.AddVertex("B");
+    auto vC = router.AddVertex("C");
+    router.AddEdge(vA, vB, 0.1);
+    router.AddEdge(vB, vC, 0.2);
+    router.SetQueueType(CDijkstraPathRouter::EQueueType::RadixHeap);
+    EXPECT_TRUE(router.SetFixedPointScale(100.0));
+
+    std::vector<CPathRouter::TVertexID> path;
+    EXPECT_EQ(0.1 + 0.2, router.FindShortestPath(vA, vC, path));
+    EXPECT_EQ(3, path.size());
+    EXPECT_EQ(CPathRouter::NoPathExists, router.FindShortestPath(vC, vA, path));
+    EXPECT_EQ(CPathRouter::NoPathExists, router.FindShortestPath(vA, 3, path));
+}
+
+// Test searches between seeded vertex sets, as used for snapped locations
+TEST_F(DijkstraPathRouterTest, SeededSets) {
+    auto vA = router.AddVertex("A");
+    auto vB = router.AddVertex("B");
+    auto vC = router.AddVertex("C");
+    auto vD = router.AddVertex("D");
+    router.AddEdge(vA, vB, 1.0);
+    router.AddEdge(vB, vC, 1.0);
+    router.AddEdge(vA, vD, 5.0);
+    router.AddEdge(vD, vC, 5.0);
+
+    std::vector<CPathRouter::TVertexID> path;
+    // The source offsets make starting at D cheaper than walking back to A
+    EXPECT_EQ(1.5 + 5.0 + 0.25, router.FindShortestPathBetweenSets({{vA, 5.0}, {vD, 1.5}}, {{vC, 0.25}}, path));
+    EXPECT_EQ(std::vector<CPathRouter::TVertexID>({vD, vC}), path);
+    // Stopping short at B and adding its offset beats reaching C
+    EXPECT_EQ(0.5 + 1.0 + 0.5, router.FindShortestPathBetweenSets({{vA, 0.5}}, {{vB, 0.5}, {vC, 2.0}}, path));
+    EXPECT_EQ(std::vector<CPathRouter::TVertexID>({vA, vB}), path);
+    // A target listed twice uses its lowest offset
+    EXPECT_EQ(0.5 + 2.0 + 0.25, router.FindShortestPathBetweenSets({{vA, 0.5}}, {{vC, 3.0}, {vD, 9.0}, {vC, 0.25}}, path));
+    EXPECT_EQ(0.5, router.FindShortestPathBetweenSets({{vB, 0.25}}, {{vB, 0.25}}, path));
+    EXPECT_EQ(1, path.size());
+    EXPECT_EQ(CPathRouter::NoPathExists, router.FindShortestPathBetweenSets({{vC, 0.0}}, {{vA, 0.0}}, path));
+    EXPECT_TRUE(path.empty());
+    EXPECT_EQ(CPathRouter::NoPathExists, router.FindShortestPathBetweenSets({{vA, -1.0}}, {{vC, 0.0}}, path));
+    EXPECT_EQ(CPathRouter::NoPathExists, router.FindShortestPathBetweenSets({}, {{vC, 0.0}}, path));
+    EXPECT_TRUE(router.SetFixedPointScale(100.0));
+    EXPECT_EQ(1.5 + 5.0 + 0.25, router.FindShortestPathBetweenSets({{vA, 5.0}, {vD, 1.5}}, {{vC, 0.25}}, path));
+}
+
+// Test search statistics for single queries and running totals
+TEST_F(DijkstraPathRouterTest, SearchStatistics) {
+    auto vA = router.AddVertex("A");
+    auto vB = router.AddVertex("B");
+    auto vC = router.AddVertex("C");
+    auto vD = router.AddVertex("D");
+    router.AddEdge(vA, vB, 1.0);
+    router.AddEdge(vB, vC, 1.0);
+    router.AddEdge(vA, vD, 5.0);
+    router.AddEdge(vD, vC, 5.0);
+
+    std::vector<CPathRouter::TVertexID> path;
+    EXPECT_FALSE(router.SearchStatisticsEnabled());
+    router.FindShortestPath(vA, vC, path);
+    EXPECT_EQ(0, router.SearchStatistics().DSearches);
+
+    router.SetSearchStatisticsEnabled(true);
+    EXPECT_EQ(2.0, router.FindShortestPath(vA, vC, path));
+    auto last = router.LastSearchStatistics();
+    EXPECT_EQ(1, last.DSearches);
+    // A, B and C are settled, D is popped after C and ends the search
+    EXPECT_EQ(3, last.DSettledVertices);
+    EXPECT_EQ(3, last.DRelaxedEdges);
+    EXPECT_EQ(4, last.DHeapPushes);
+    EXPECT_EQ(4, last.DHeapPops);
+    EXPECT_EQ(2, last.DMaxHeapSize);
+
+    router.FindShortestPath(vB, vC, path);
+    auto total = router.SearchStatistics();
+    EXPECT_EQ(2, total.DSearches);
+    EXPECT_EQ(3 + 2, total.DSettledVertices);
+    EXPECT_EQ(2, total.DMaxHeapSize);
+
+    router.ResetSearchStatistics();
+    EXPECT_EQ(0, router.SearchStatistics().DSearches);
+    EXPECT_EQ(0, router.LastSearchStatistics().DSettledVertices);
+}
+
+// Statistics of concurrent searches all reach the running total
+TEST_F(DijkstraPathRouterTest, ConcurrentSearchStatistics) {
+    auto vA = router.AddVertex("A");
+    auto vB = router.AddVertex("B");
+    auto vC = router.AddVertex("C");
+    router.AddEdge(vA, vB, 1.0);
+    router.AddEdge(vB, vC, 1.0);
+    router.SetSearchStatisticsEnabled(true);
+
+    const std::size_t Threads = 4, Searches = 200;
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < Threads; ++t) {
+        workers.emplace_back([&]() {
+            std::vector<CPathRouter::TVertexID> path;
+            for (std::size_t i = 0; i < Searches; ++i)
+                router.FindShortestPath(vA, vC, path);
+        });
+    }
+    for (auto &worker : workers)
+        worker.join();
+    auto total = router.SearchStatistics();
+    EXPECT_EQ(Threads * Searches, total.DSearches);
+    EXPECT_EQ(3 * Threads * Searches, total.DSettledVertices);
+    EXPECT_EQ(3, router.LastSearchStatistics().DSettledVertices);
+}
+
 // Test precompute function (mostly a placeholder since the implementation doesn't do much)
 TEST_F(DijkstraPathRouterTest, Precomputation) {
     auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
     EXPECT_TRUE(router.Precompute(deadline));
+    // A deadline that has passed is caught before any vertex is prioritized
+    auto v0 = router.AddVertex("0");
+    auto v1 = router.AddVertex("1");
+    router.AddEdge(v0, v1, 1.0, true);
+    EXPECT_FALSE(router.Precompute(std::chrono::steady_clock::now() - std::chrono::seconds(1)));
+    EXPECT_FALSE(router.HasHierarchy());
 }
 
 // Test invalid vertex IDs
@@ -200,4 +454,36 @@ TEST_F(DijkstraPathRouterTest, InvalidVertexIds) {
     double distance2 = router.FindShortestPath(v0, 100, path);
     EXPECT_EQ(CPathRouter::NoPathExists, distance2);
     EXPECT_TRUE(path.empty());
-}
\ No newline at end of file
+}
+// Test the typed tag router and its reverse index
+TEST(DijkstraPathRouterTTest, TypedTags) {
+    CDijkstraPathRouterT<std::string> router(true);
+    auto v0 = router.AddVertex(std::string("A"));
+    auto v1 = router.AddVertex(std::string("B"));
+    auto v2 = router.AddVertex(std::any(std::string("C")));
+    EXPECT_EQ(3, router.VertexCount());
+    EXPECT_EQ(2, v2);
+    EXPECT_EQ("B", router.VertexTag(v1));
+    EXPECT_EQ("C", std::any_cast<std::string>(router.GetVertexTag(v2)));
+    EXPECT_FALSE(router.GetVertexTag(3).has_value());
+    EXPECT_EQ(v0, router.VertexByTag("A"));
+    EXPECT_EQ(v2, router.VertexByTag("C"));
+    EXPECT_EQ(CPathRouter::InvalidVertexID, router.VertexByTag("D"));
+    // Tags of another type are refused through the std::any interface
+    EXPECT_EQ(CPathRouter::InvalidVertexID, router.AddVertex(std::any(42)));
+    EXPECT_EQ(3, router.VertexCount());
+
+    EXPECT_TRUE(router.AddEdge(v0, v1, 1.0));
+    EXPECT_TRUE(router.AddEdge(v1, v2, 2.0));
+    EXPECT_FALSE(router.AddEdge(v1, 3, 2.0));
+    std::vector<CPathRouter::TVertexID> path;
+    EXPECT_EQ(3.0, router.FindShortestPath(router.VertexByTag("A"), router.VertexByTag("C"), path));
+    std::vector<CPathRouter::TVertexID> expected = {v0, v1, v2};
+    EXPECT_EQ(expected, path);
+
+    CDijkstraPathRouterT<int> unindexed;
+    auto u0 = unindexed.AddVertex(7);
+    EXPECT_FALSE(unindexed.TagsIndexed());
+    EXPECT_EQ(7, unindexed.VertexTag(u0));
+    EXPECT_EQ(CPathRouter::InvalidVertexID, unindexed.VertexByTag(7));
+}
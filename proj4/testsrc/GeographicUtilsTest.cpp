@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include "GeographicUtils.h"
+#include <random>
+
+class GeographicUtilsBatch : public ::testing::Test{
+    protected:
+        std::vector< CStreetMap::TLocation > DSources;
+        std::vector< CStreetMap::TLocation > DDestinations;
+
+        // Random pairs up to maxoffset degrees apart, below maxlat degrees
+        void Generate(double maxlat, double maxoffset){
+            std::mt19937 Generator(39);
+            std::uniform_real_distribution<double> Lat(-maxlat,maxlat), Lon(-180.0,180.0), Offset(-maxoffset,maxoffset);
+            DSources.clear();
+            DDestinations.clear();
+            for(int Index = 0; Index < 10000; Index++){
+                CStreetMap::TLocation Source{Lat(Generator),Lon(Generator)};
+                DSources.push_back(Source);
+                DDestinations.push_back({std::clamp(Source.first + Offset(Generator),-90.0,90.0),Source.second + Offset(Generator)});
+            }
+        }
+};
+
+TEST_F(GeographicUtilsBatch, ExactTest){
+    Generate(90.0,180.0);
+    std::vector<double> Distances(DSources.size());
+    SGeographicUtils::HaversineDistancesInMiles(DSources.data(),DDestinations.data(),DSources.size(),Distances.data());
+    for(std::size_t Index = 0; Index < DSources.size(); Index++){
+        EXPECT_EQ(Distances[Index],SGeographicUtils::HaversineDistanceInMiles(DSources[Index],DDestinations[Index]));
+    }
+    std::vector<double> Lengths(DSources.size() - 1);
+    SGeographicUtils::HaversinePolylineInMiles(DSources.data(),DSources.size(),Lengths.data());
+    for(std::size_t Index = 1; Index < DSources.size(); Index++){
+        EXPECT_EQ(Lengths[Index - 1],SGeographicUtils::HaversineDistanceInMiles(DSources[Index - 1],DSources[Index]));
+    }
+    SGeographicUtils::HaversinePolylineInMiles(DSources.data(),1,Lengths.data());
+}
+
+TEST_F(GeographicUtilsBatch, FastHaversineTest){
+    Generate(90.0,180.0);
+    std::vector<double> Distances(DSources.size());
+    SGeographicUtils::FastHaversineDistancesInMiles(DSources.data(),DDestinations.data(),DSources.size(),Distances.data());
+    for(std::size_t Index = 0; Index < DSources.size(); Index++){
+        double Expected = SGeographicUtils::HaversineDistanceInMiles(DSources[Index],DDestinations[Index]);
+        EXPECT_NEAR(Distances[Index],Expected,Expected * 1e-10 + 1e-11);
+    }
+    Generate(70.0,0.1);
+    SGeographicUtils::FastHaversineDistancesInMiles(DSources.data(),DDestinations.data(),DSources.size(),Distances.data());
+    for(std::size_t Index = 0; Index < DSources.size(); Index++){
+        EXPECT_NEAR(Distances[Index],SGeographicUtils::HaversineDistanceInMiles(DSources[Index],DDestinations[Index]),1e-11);
+    }
+}
+
+TEST_F(GeographicUtilsBatch, EquirectangularTest){
+    // 0.01 degrees is under a mile, 0.1 degrees under 10 miles
+    for(auto [MaxOffset, Tolerance] : {std::make_pair(0.01,1e-7),std::make_pair(0.1,1e-5)}){
+        Generate(70.0,MaxOffset);
+        std::vector<double> Distances(DSources.size());
+        SGeographicUtils::EquirectangularDistancesInMiles(DSources.data(),DDestinations.data(),DSources.size(),Distances.data());
+        for(std::size_t Index = 0; Index < DSources.size(); Index++){
+            double Expected = SGeographicUtils::HaversineDistanceInMiles(DSources[Index],DDestinations[Index]);
+            EXPECT_NEAR(Distances[Index],Expected,Expected * Tolerance + 1e-11);
+        }
+    }
+    // Across the antimeridian the short way round is taken
+    CStreetMap::TLocation West{10.0,179.99}, East{10.0,-179.99};
+    double Distance;
+    SGeographicUtils::EquirectangularDistancesInMiles(&West,&East,1,&Distance);
+    EXPECT_NEAR(Distance,SGeographicUtils::HaversineDistanceInMiles(West,East),1e-6);
+}
@@ -129,4 +129,77 @@ TEST(OSMTest, WayTest){
     EXPECT_EQ(TempWay->AttributeCount(),1);
     EXPECT_TRUE(TempWay->HasAttribute("oneway"));
     EXPECT_EQ(TempWay->GetAttribute("oneway"),"yes");
-}
\ No newline at end of file
+}
+TEST(OSMTest, ArenaLifetimeTest){
+    auto InStream = std::make_shared<CStringDataSource>("<?xml version='1.0' encoding='UTF-8'?>"
+                                                        "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                        "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\">"
+                                                        "<tag k=\"highway\" v=\"a value long enough to leave the inline string buffer\"/>"
+                                                        "<tag k=\"highway\" v=\"traffic_signals\"/>"
+                                                        "</node>"
+                                                        "<node id=\"2\" lat=\"38.5\" lon=\"-121.71\"/>"
+                                                        "<way id=\"3\">"
+                                                        "<nd ref=\"1\"/>"
+                                                        "<nd ref=\"2\"/>"
+                                                        "<tag k=\"name\" v=\"First Street\"/>"
+                                                        "</way>"
+                                                        "</osm>");
+    std::shared_ptr<CStreetMap::SNode> TempNode;
+    std::shared_ptr<CStreetMap::SWay> TempWay;
+    {
+        auto StreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(InStream));
+        TempNode = StreetMap->NodeByID(1);
+        TempWay = StreetMap->WayByIndex(0);
+        EXPECT_EQ(TempNode,StreetMap->NodeByIndex(0));
+    }
+    // Handed out objects keep the map's storage alive
+    ASSERT_TRUE(bool(TempNode));
+    EXPECT_EQ(TempNode->ID(),1);
+    EXPECT_EQ(TempNode->AttributeCount(),1);
+    EXPECT_EQ(TempNode->GetAttributeKey(0),"highway");
+    EXPECT_EQ(TempNode->GetAttribute("highway"),"traffic_signals");
+    ASSERT_TRUE(bool(TempWay));
+    EXPECT_EQ(TempWay->NodeCount(),2);
+    EXPECT_EQ(TempWay->GetNodeID(1),2);
+    EXPECT_EQ(TempWay->GetAttribute("name"),"First Street");
+}
+
+TEST(OSMTest, PointerAccessTest){
+    auto InStream = std::make_shared<CStringDataSource>("<?xml version='1.0' encoding='UTF-8'?>"
+                                                        "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                        "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                        "<node id=\"3\" lat=\"38.5\" lon=\"-121.71\"/>"
+                                                        "<node id=\"2\" lat=\"38.5\" lon=\"-121.72\"/>"
+                                                        "<way id=\"4\">"
+                                                        "<nd ref=\"1\"/>"
+                                                        "<nd ref=\"3\"/>"
+                                                        "</way>"
+                                                        "<way id=\"5\">"
+                                                        "<nd ref=\"3\"/>"
+                                                        "<nd ref=\"2\"/>"
+                                                        "</way>"
+                                                        "</osm>");
+    COpenStreetMap StreetMap(std::make_shared<CXMLReader>(InStream));
+
+    // Node IDs are out of order and way IDs ascend, both lookups must agree
+    for(std::size_t Index = 0; Index < StreetMap.NodeCount(); Index++){
+        auto Node = StreetMap.NodePtrByIndex(Index);
+        ASSERT_NE(Node,nullptr);
+        EXPECT_EQ(Node,StreetMap.NodeByIndex(Index).get());
+        EXPECT_EQ(StreetMap.NodePtrByID(Node->ID()),Node);
+        EXPECT_EQ(StreetMap.NodeByID(Node->ID()).get(),Node);
+    }
+    for(std::size_t Index = 0; Index < StreetMap.WayCount(); Index++){
+        auto Way = StreetMap.WayPtrByIndex(Index);
+        ASSERT_NE(Way,nullptr);
+        EXPECT_EQ(Way,StreetMap.WayByIndex(Index).get());
+        EXPECT_EQ(StreetMap.WayPtrByID(Way->ID()),Way);
+        EXPECT_EQ(StreetMap.WayByID(Way->ID()).get(),Way);
+    }
+    EXPECT_EQ(StreetMap.NodePtrByIndex(3),nullptr);
+    EXPECT_EQ(StreetMap.NodePtrByID(4),nullptr);
+    EXPECT_EQ(StreetMap.NodeByID(0),nullptr);
+    EXPECT_EQ(StreetMap.WayPtrByIndex(2),nullptr);
+    EXPECT_EQ(StreetMap.WayPtrByID(6),nullptr);
+    EXPECT_EQ(StreetMap.WayByID(3),nullptr);
+}
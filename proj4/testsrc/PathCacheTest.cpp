@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include "PathCache.h"
+
+using EMode = CTransportationPlanner::ETransportationMode;
+
+TEST(PathCache, CodecTest){
+    std::vector<CPathCache::TTripStep> Path = {{EMode::Walk,10},{EMode::Walk,9},{EMode::Bus,8000000000ULL},
+                                                {EMode::Bus,7},{EMode::Bike,0},{EMode::Bike,std::numeric_limits<CPathCache::TNodeID>::max()}};
+    std::vector<CPathCache::TTripStep> Decoded;
+    std::vector<std::uint8_t> Encoded;
+    CPathCache::EncodePath(Path,Encoded);
+    EXPECT_TRUE(CPathCache::DecodePath(Encoded,Decoded));
+    EXPECT_EQ(Decoded,Path);
+    CPathCache::EncodePath({},Encoded);
+    EXPECT_TRUE(Encoded.empty());
+    EXPECT_TRUE(CPathCache::DecodePath(Encoded,Decoded));
+    EXPECT_TRUE(Decoded.empty());
+    Encoded = {0x84};
+    EXPECT_FALSE(CPathCache::DecodePath(Encoded,Decoded));
+}
+
+TEST(PathCache, LookupTest){
+    CPathCache Cache(4);
+    std::vector<CPathCache::TTripStep> Path = {{EMode::Walk,1},{EMode::Bike,2}}, Result;
+    double Cost = 0.0;
+    EXPECT_FALSE(Cache.Lookup(1,2,CPathCache::EMetric::Time,0,Cost,Result));
+    Cache.Insert(1,2,CPathCache::EMetric::Time,0,1.5,Path);
+    EXPECT_FALSE(Cache.Lookup(1,2,CPathCache::EMetric::Distance,0,Cost,Result));
+    EXPECT_TRUE(Cache.Lookup(1,2,CPathCache::EMetric::Time,0,Cost,Result));
+    EXPECT_EQ(Cost,1.5);
+    EXPECT_EQ(Result,Path);
+    auto Statistics = Cache.Statistics();
+    EXPECT_EQ(Statistics.DHits,1);
+    EXPECT_EQ(Statistics.DMisses,2);
+    EXPECT_EQ(Statistics.DEntries,1);
+}
+
+TEST(PathCache, EvictionTest){
+    CPathCache Cache(2);
+    std::vector<CPathCache::TTripStep> Path = {{EMode::Walk,1}}, Result;
+    double Cost;
+    Cache.Insert(1,1,CPathCache::EMetric::Distance,0,1.0,Path);
+    Cache.Insert(2,2,CPathCache::EMetric::Distance,0,2.0,Path);
+    EXPECT_TRUE(Cache.Lookup(1,1,CPathCache::EMetric::Distance,0,Cost,Result));
+    Cache.Insert(3,3,CPathCache::EMetric::Distance,0,3.0,Path);
+    EXPECT_TRUE(Cache.Lookup(1,1,CPathCache::EMetric::Distance,0,Cost,Result));
+    EXPECT_FALSE(Cache.Lookup(2,2,CPathCache::EMetric::Distance,0,Cost,Result));
+    EXPECT_TRUE(Cache.Lookup(3,3,CPathCache::EMetric::Distance,0,Cost,Result));
+    EXPECT_EQ(Cache.Statistics().DEvictions,1);
+    EXPECT_EQ(Cache.Statistics().DEntries,2);
+}
+
+TEST(PathCache, InvalidationTest){
+    CPathCache Cache(2);
+    std::vector<CPathCache::TTripStep> Path = {{EMode::Walk,1}}, Result;
+    double Cost;
+    Cache.Insert(1,1,CPathCache::EMetric::Distance,0,1.0,Path);
+    EXPECT_FALSE(Cache.Lookup(1,1,CPathCache::EMetric::Distance,1,Cost,Result));
+    EXPECT_EQ(Cache.Statistics().DInvalidations,1);
+    EXPECT_EQ(Cache.Statistics().DEntries,0);
+    Cache.Insert(1,1,CPathCache::EMetric::Distance,1,1.0,Path);
+    Cache.Clear();
+    EXPECT_FALSE(Cache.Lookup(1,1,CPathCache::EMetric::Distance,1,Cost,Result));
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include "StringDataSource.h"
+#include "XMLReader.h"
+#include "OpenStreetMap.h"
+#include "RoutingProfile.h"
+
+static std::shared_ptr<COpenStreetMap> LoadWays(const std::string &ways){
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>" + ways + "</osm>");
+    auto XMLReader = std::make_shared<CXMLReader>(InStreamOSM);
+    return std::make_shared<COpenStreetMap>(XMLReader);
+}
+
+TEST(RoutingProfile, WayAttributesTest){
+    auto StreetMap = LoadWays("<way id=\"10\"><nd ref=\"1\"/><nd ref=\"2\"/>"
+                              "<tag k=\"maxspeed\" v=\"35 mph\"/><tag k=\"oneway\" v=\"yes\"/></way>"
+                              "<way id=\"11\"><nd ref=\"1\"/><nd ref=\"2\"/>"
+                              "<tag k=\"maxspeed\" v=\"fast\"/><tag k=\"highway\" v=\"steps\"/></way>"
+                              "<way id=\"12\"><nd ref=\"1\"/><nd ref=\"2\"/>"
+                              "<tag k=\"highway\" v=\"motorway\"/><tag k=\"bicycle\" v=\"no\"/></way>");
+    ASSERT_EQ(StreetMap->WayCount(),3);
+    auto Way = SRoutingWay::FromWay(*StreetMap->WayByID(10),25.0);
+    EXPECT_EQ(Way.DSpeedLimit,35.0);
+    EXPECT_TRUE(Way.Has(SRoutingWay::Oneway));
+    Way = SRoutingWay::FromWay(*StreetMap->WayByID(11),25.0);
+    EXPECT_EQ(Way.DSpeedLimit,25.0);
+    EXPECT_TRUE(Way.Has(SRoutingWay::Steps));
+    EXPECT_FALSE(Way.Has(SRoutingWay::Oneway));
+    Way = SRoutingWay::FromWay(*StreetMap->WayByID(12),25.0);
+    EXPECT_TRUE(Way.Has(SRoutingWay::Motorway));
+    EXPECT_TRUE(Way.Has(SRoutingWay::NoBicycle));
+}
+
+TEST(RoutingProfile, AccessTest){
+    SRoutingWay Oneway{30.0, SRoutingWay::Oneway};
+    SRoutingWay Steps{25.0, SRoutingWay::Steps};
+    SRoutingWay Motorway{65.0, SRoutingWay::Motorway};
+    EXPECT_TRUE(SPedestrianProfile::Allows(Oneway,true));
+    EXPECT_FALSE(SBicycleProfile::Allows(Oneway,true));
+    EXPECT_TRUE(SBicycleProfile::Allows(Oneway,false));
+    EXPECT_FALSE(SCarProfile::Allows(Oneway,true));
+    EXPECT_TRUE(SPedestrianProfile::Allows(Steps,false));
+    EXPECT_FALSE(SWheelchairProfile::Allows(Steps,false));
+    EXPECT_FALSE(SCarProfile::Allows(Steps,false));
+    EXPECT_FALSE(SPedestrianProfile::Allows(Motorway,false));
+    EXPECT_TRUE(SBusProfile::Allows(Motorway,false));
+}
+
+TEST(RoutingProfile, EdgeCostTest){
+    SRoutingSpeeds Speeds{3.0, 8.0, 25.0};
+    SRoutingWay Street{30.0, SRoutingWay::Oneway};
+    EXPECT_EQ(ProfileEdgeCost<SPedestrianProfile>(Street,true,6.0,Speeds),2.0);
+    EXPECT_EQ(ProfileEdgeCost<SBicycleProfile>(Street,false,4.0,Speeds),0.5);
+    EXPECT_EQ(ProfileEdgeCost<SCarProfile>(Street,false,15.0,Speeds),0.5);
+    EXPECT_EQ(ProfileEdgeCost<SCarProfile>(Street,true,15.0,Speeds),std::numeric_limits<double>::infinity());
+}
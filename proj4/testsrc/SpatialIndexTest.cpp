@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include "SpatialIndex.h"
+#include "GeographicUtils.h"
+#include <algorithm>
+#include <random>
+
+TEST(SpatialIndex, EmptyTest){
+    CSpatialIndex Index(std::vector< std::pair< CSpatialIndex::TNodeID, CSpatialIndex::TLocation > >{});
+    std::vector< std::pair< CSpatialIndex::TNodeID, double > > Nodes;
+    EXPECT_EQ(Index.NodeCount(),0);
+    EXPECT_EQ(Index.NearestNode({38.5,-121.7}),CSpatialIndex::TNodeID(CStreetMap::InvalidNodeID));
+    EXPECT_EQ(Index.NearestNodes({38.5,-121.7},3,Nodes),0);
+    EXPECT_EQ(Index.NodesWithinRadius({38.5,-121.7},10.0,Nodes),0);
+}
+
+TEST(SpatialIndex, SimpleTest){
+    CSpatialIndex Index({{1,{38.5,-121.7}},{2,{38.6,-121.7}},{3,{38.6,-121.8}},{4,{38.5,-121.8}}});
+    std::vector< std::pair< CSpatialIndex::TNodeID, double > > Nodes;
+    EXPECT_EQ(Index.NodeCount(),4);
+    EXPECT_EQ(Index.NearestNode({38.51,-121.71}),1);
+    EXPECT_EQ(Index.NearestNode({38.7,-121.9}),3);
+    ASSERT_EQ(Index.NearestNodes({38.51,-121.71},2,Nodes),2);
+    EXPECT_EQ(Nodes[0].first,1);
+    EXPECT_EQ(Nodes[1].first,4);
+    EXPECT_EQ(Nodes[0].second,SGeographicUtils::HaversineDistanceInMiles({38.51,-121.71},{38.5,-121.7}));
+    ASSERT_EQ(Index.NodesWithinRadius({38.5,-121.7},7.0,Nodes),3);
+    EXPECT_EQ(Nodes[0].first,1);
+    EXPECT_EQ(Nodes[0].second,0.0);
+    EXPECT_EQ(Index.NodesWithinRadius({38.5,-121.7},-1.0,Nodes),0);
+}
+
+TEST(SpatialIndex, BruteForceTest){
+    std::mt19937 Generator(37);
+    std::uniform_real_distribution<double> Lat(38.4,38.7), Lon(-121.9,-121.6);
+    std::vector< std::pair< CSpatialIndex::TNodeID, CSpatialIndex::TLocation > > Points;
+    for(CSpatialIndex::TNodeID ID = 0; ID < 5000; ID++){
+        Points.push_back({ID,{Lat(Generator),Lon(Generator)}});
+    }
+    CSpatialIndex Index(Points);
+    std::vector< std::pair< CSpatialIndex::TNodeID, double > > Nodes;
+    for(int Query = 0; Query < 50; Query++){
+        CSpatialIndex::TLocation Location{Lat(Generator),Lon(Generator)};
+        std::vector< std::pair< double, CSpatialIndex::TNodeID > > Expected;
+        for(auto &Point : Points){
+            Expected.push_back({SGeographicUtils::HaversineDistanceInMiles(Location,Point.second),Point.first});
+        }
+        std::sort(Expected.begin(),Expected.end());
+        EXPECT_EQ(Index.NearestNode(Location),Expected[0].second);
+        ASSERT_EQ(Index.NearestNodes(Location,10,Nodes),10);
+        for(std::size_t Rank = 0; Rank < 10; Rank++){
+            EXPECT_EQ(Nodes[Rank].first,Expected[Rank].second);
+        }
+        std::size_t WithinCount = 0;
+        while(Expected[WithinCount].first <= 0.5){
+            WithinCount++;
+        }
+        EXPECT_EQ(Index.NodesWithinRadius(Location,0.5,Nodes),WithinCount);
+    }
+}
+
+TEST(SegmentIndex, SimpleTest){
+    CSegmentIndex Index({{{38.5,-121.7},{38.6,-121.7}},{{38.6,-121.7},{38.6,-121.8}}});
+    CSegmentIndex::SMatch Match;
+    EXPECT_EQ(Index.SegmentCount(),2);
+    ASSERT_TRUE(Index.NearestSegment({38.55,-121.69},Match));
+    EXPECT_EQ(Match.DSegment,0);
+    EXPECT_NEAR(Match.DFraction,0.5,1e-9);
+    EXPECT_NEAR(Match.DLocation.first,38.55,1e-9);
+    EXPECT_NEAR(Match.DLocation.second,-121.7,1e-9);
+    EXPECT_NEAR(Match.DDistance,SGeographicUtils::HaversineDistanceInMiles({38.55,-121.69},{38.55,-121.7}),1e-9);
+    ASSERT_TRUE(Index.NearestSegment({38.7,-121.9},Match));
+    EXPECT_EQ(Match.DSegment,1);
+    EXPECT_EQ(Match.DFraction,1.0);
+    EXPECT_EQ(Match.DLocation,CSegmentIndex::TLocation(38.6,-121.8));
+    std::vector< CSegmentIndex::SMatch > Matches;
+    ASSERT_EQ(Index.NearestSegments({38.61,-121.75},2,Matches),2);
+    EXPECT_EQ(Matches[0].DSegment,1);
+    EXPECT_EQ(Matches[1].DSegment,0);
+    CSegmentIndex Empty({});
+    EXPECT_FALSE(Empty.NearestSegment({38.5,-121.7},Match));
+}
+
+TEST(SegmentIndex, BruteForceTest){
+    std::mt19937 Generator(38);
+    std::uniform_real_distribution<double> Lat(38.4,38.7), Lon(-121.9,-121.6), Offset(-0.01,0.01);
+    std::vector< CSegmentIndex::SSegment > Segments;
+    for(int Count = 0; Count < 3000; Count++){
+        CSegmentIndex::TLocation Start{Lat(Generator),Lon(Generator)};
+        Segments.push_back({Start,{Start.first + Offset(Generator),Start.second + Offset(Generator)}});
+    }
+    CSegmentIndex Index(Segments);
+    std::vector< CSegmentIndex::SMatch > Matches;
+    for(int Query = 0; Query < 50; Query++){
+        CSegmentIndex::TLocation Location{Lat(Generator),Lon(Generator)};
+        ASSERT_EQ(Index.NearestSegments(Location,5,Matches),5);
+        // Every segment is at least as far as the fifth match
+        for(std::size_t SegmentIndex = 0; SegmentIndex < Segments.size(); SegmentIndex++){
+            CSegmentIndex Single({Segments[SegmentIndex]});
+            CSegmentIndex::SMatch Match;
+            Single.NearestSegment(Location,Match);
+            bool Matched = false;
+            for(auto &Found : Matches){
+                Matched |= Found.DSegment == SegmentIndex;
+            }
+            if(!Matched){
+                EXPECT_GE(Match.DDistance,Matches.back().DDistance);
+            }
+        }
+    }
+}
@@ -3,6 +3,11 @@
 #include "TransportationPlannerCommandLine.h"
 #include "StringDataSink.h"
 #include "StringDataSource.h"
+#include "XMLReader.h"
+#include "OpenStreetMap.h"
+#include "CSVBusSystem.h"
+#include "TransportationPlannerConfig.h"
+#include "DijkstraTransportationPlanner.h"
 
 class CMockTransportationPlanner : public CTransportationPlanner{
     public:
@@ -11,8 +16,9 @@ class CMockTransportationPlanner : public CTransportationPlanner{
         MOCK_METHOD(double, FindShortestPath, (TNodeID src, TNodeID dest, std::vector< TNodeID > &path), (override));
         MOCK_METHOD(double, FindFastestPath, (TNodeID src, TNodeID dest, std::vector< TTripStep > &path), (override));
         MOCK_METHOD(bool, GetPathDescription, (const std::vector< TTripStep > &path, std::vector< std::string > &desc), (const, override));
+        MOCK_METHOD(bool, ConstructionReports, (std::vector< SConstructionReport > &reports), (const, override));
 };
-/*
+
 struct SMockNode : public CStreetMap::SNode{
     MOCK_METHOD(CStreetMap::TNodeID, ID, (), (const, noexcept, override));
     MOCK_METHOD(CStreetMap::TLocation, Location, (), (const, noexcept, override));
@@ -66,6 +72,7 @@ TEST(TransporationPlannerCommandLine, HelpTest){
                                     "         Calculates the distance for the shortest path from start to end\n"
                                     "save     Saves the last calculated path to file\n"
                                     "print    Prints the steps for the last calculated path\n"
+                                    "report   Prints the load time and memory use of the map and planner\n"
                                     "> ");
     EXPECT_TRUE(ErrorSink->String().empty());
 }
@@ -245,6 +252,37 @@ TEST(TransporationPlannerCommandLine, SaveTest){
     EXPECT_TRUE(ErrorSink->String().empty());
 }
 
+TEST(TransporationPlannerCommandLine, ReportTest){
+    auto InputSource = std::make_shared<CStringDataSource>( "report\n"
+                                                            "report\n"
+                                                            "exit\n");
+    auto OutputSink = std::make_shared<CStringDataSink>();
+    auto ErrorSink = std::make_shared<CStringDataSink>();
+    auto MockPlanner = std::make_shared<CMockTransportationPlanner>();
+    auto MockFactory = std::make_shared<CMockFactory>();
+    SConstructionReport Report;
+    Report.DName = "Planner";
+    Report.AddPhase("build",std::chrono::milliseconds(2));
+    Report.AddComponent("edges",4,100);
+
+    EXPECT_CALL(*MockPlanner, ConstructionReports(::testing::_))
+        .WillOnce(::testing::DoAll(::testing::SetArgReferee<0>(std::vector< SConstructionReport >{Report}),::testing::Return(true)))
+        .WillOnce(::testing::Return(false));
+
+    CTransportationPlannerCommandLine CommandLine(InputSource,OutputSink,ErrorSink,MockFactory,MockPlanner);
+
+    EXPECT_TRUE(CommandLine.ProcessCommands());
+    EXPECT_EQ(OutputSink->String(),"> "
+                                    "Planner\n"
+                                    "  phase  build                                  2.000 ms\n"
+                                    "  phase  total                                  2.000 ms\n"
+                                    "  memory edges                                    100 bytes          4 items      25.0 bytes each\n"
+                                    "  memory total                                    100 bytes\n"
+                                    "> "
+                                    "> ");
+    EXPECT_EQ(ErrorSink->String(),"No construction report available.\n");
+}
+
 TEST(TransporationPlannerCommandLine, ErrorTest){
     auto InputSource = std::make_shared<CStringDataSource>( "foo\n"
                                                             "node\n"
@@ -290,4 +328,106 @@ TEST(TransporationPlannerCommandLine, ErrorTest){
                                     "No valid path to print, see help.\n");
 }
 
-*/
\ No newline at end of file
+TEST(TransporationPlannerCommandLine, BatchTest){
+    auto InputSource = std::make_shared<CStringDataSource>( "fastest 123 456\n"
+                                                            "shortest 123 456\n"
+                                                            "foo\n"
+                                                            "count\n"
+                                                            "shortest 456 123\n"
+                                                            "save\n"
+                                                            "exit\n"
+                                                            "count\n");
+    auto OutputSink = std::make_shared<CStringDataSink>();
+    auto ErrorSink = std::make_shared<CStringDataSink>();
+    auto MockPlanner = std::make_shared<CMockTransportationPlanner>();
+    auto MockFactory = std::make_shared<CMockFactory>();
+    auto SaveSink = std::make_shared<CStringDataSink>();
+    std::vector<CTransportationPlanner::TTripStep> ExpectedSteps = {{CTransportationPlanner::ETransportationMode::Walk,123},
+                                                                    {CTransportationPlanner::ETransportationMode::Walk,456}};
+    std::vector<CTransportationPlanner::TNodeID> ExpectedPath = {123, 456};
+    std::vector<CTransportationPlanner::TNodeID> ReversePath = {456, 789, 123};
+
+    EXPECT_CALL(*MockPlanner, NodeCount())
+        .WillRepeatedly(::testing::Return(4));
+    EXPECT_CALL(*MockPlanner, FindFastestPath(123, 456, ::testing::_))
+        .WillRepeatedly(::testing::DoAll(::testing::SetArgReferee<2>(ExpectedSteps),::testing::Return(0.65)));
+    EXPECT_CALL(*MockPlanner, FindShortestPath(123, 456, ::testing::_))
+        .WillRepeatedly(::testing::DoAll(::testing::SetArgReferee<2>(ExpectedPath),::testing::Return(5.2)));
+    EXPECT_CALL(*MockPlanner, FindShortestPath(456, 123, ::testing::_))
+        .WillRepeatedly(::testing::DoAll(::testing::SetArgReferee<2>(ReversePath),::testing::Return(6.25)));
+    EXPECT_CALL(*MockFactory, CreateSink(std::string("456_123_6.250000mi.csv")))
+        .WillRepeatedly(::testing::Return(SaveSink));
+
+    CTransportationPlannerCommandLine CommandLine(InputSource,OutputSink,ErrorSink,MockFactory,MockPlanner);
+
+    EXPECT_TRUE(CommandLine.ProcessBatchCommands(3));
+    EXPECT_EQ(OutputSink->String(), "Fastest path takes 39 min.\n"
+                                    "Shortest path is 5.2 mi.\n"
+                                    "4 nodes\n"
+                                    "Shortest path is 6.2 mi.\n"
+                                    "Path saved to <results>/456_123_6.250000mi.csv\n");
+    EXPECT_EQ(SaveSink->String(),"mode,node_id\n"
+                                 "Walk,456\n"
+                                 "Walk,789\n"
+                                 "Walk,123");
+    EXPECT_EQ(ErrorSink->String(),"Unknown command \"foo\" type help for help.\n");
+}
+
+TEST(TransporationPlannerCommandLine, BatchWorkersTest){
+    // A grid of streets with a bus line along its first row, batch output
+    // must not depend on how many workers run the queries
+    const int Size = 16;
+    std::string OSMString = "<?xml version='1.0' encoding='UTF-8'?><osm version=\"0.6\" generator=\"osmconvert 0.8.5\">";
+    for(int Row = 0; Row < Size; Row++){
+        for(int Col = 0; Col < Size; Col++){
+            OSMString += "<node id=\"" + std::to_string(Row * Size + Col + 1) + "\" lat=\"" + std::to_string(38.5 + Row * 0.002) + "\" lon=\"" + std::to_string(-121.7 + Col * 0.002) + "\"/>";
+        }
+    }
+    for(int Line = 0; Line < Size; Line++){
+        std::string RowWay = "<way id=\"" + std::to_string(1000 + Line) + "\">";
+        std::string ColWay = "<way id=\"" + std::to_string(2000 + Line) + "\">";
+        for(int Step = 0; Step < Size; Step++){
+            RowWay += "<nd ref=\"" + std::to_string(Line * Size + Step + 1) + "\"/>";
+            ColWay += "<nd ref=\"" + std::to_string(Step * Size + Line + 1) + "\"/>";
+        }
+        RowWay += Line % 3 == 1 ? "<tag k=\"oneway\" v=\"yes\"/></way>" : "</way>";
+        ColWay += "<tag k=\"name\" v=\"Street " + std::to_string(Line) + "\"/></way>";
+        OSMString += RowWay + ColWay;
+    }
+    OSMString += "</osm>";
+    std::string StopsString = "stop_id,node_id";
+    std::string RoutesString = "route,stop_id";
+    for(int Stop = 0; Stop < Size; Stop += 3){
+        StopsString += "\n" + std::to_string(Stop + 1) + "," + std::to_string(Stop + 1);
+        RoutesString += "\nA," + std::to_string(Stop + 1);
+    }
+    auto StreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(OSMString)));
+    auto BusSystem = std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(StopsString),','),
+                                                     std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(RoutesString),','));
+    auto Planner = std::make_shared<CDijkstraTransportationPlanner>(std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem,3.0,8.0,25.0,30.0,0));
+
+    std::string Commands;
+    unsigned Seed = 1;
+    auto NextNode = [&](){
+        Seed = Seed * 1103515245 + 12345;
+        return std::to_string((Seed >> 16) % (Size * Size) + 1);
+    };
+    for(int Index = 0; Index < 400; Index++){
+        Commands += (Index % 2 ? "fastest " : "shortest ") + NextNode() + " " + NextNode() + "\n";
+        if(Index % 5 == 0){
+            Commands += "print\n";
+        }
+    }
+    auto RunBatch = [&](std::size_t workers){
+        auto OutputSink = std::make_shared<CStringDataSink>();
+        auto ErrorSink = std::make_shared<CStringDataSink>();
+        CTransportationPlannerCommandLine CommandLine(std::make_shared<CStringDataSource>(Commands),OutputSink,ErrorSink,std::make_shared<CMockFactory>(),Planner);
+        EXPECT_TRUE(CommandLine.ProcessBatchCommands(workers));
+        return OutputSink->String() + ErrorSink->String();
+    };
+    std::string Expected = RunBatch(1);
+    EXPECT_NE(Expected.find("Shortest path is"),std::string::npos);
+    EXPECT_NE(Expected.find("Fastest path takes"),std::string::npos);
+    EXPECT_EQ(RunBatch(8),Expected);
+    EXPECT_EQ(RunBatch(3),Expected);
+}